@@ -0,0 +1,52 @@
+﻿#pragma once
+#include <cstddef>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+// Инструменты пакетного поиска: программная предвыборка и чередование
+// независимых поисков (AMAC - asynchronous memory access chaining)
+
+constexpr size_t BATCH_BLOCK = 64;   //ключей, хешируемых и предвыбираемых за один проход
+constexpr size_t BATCH_WINDOW = 16;  //одновременно продвигаемых поисков
+
+// Предвыборка строки кэша для чтения
+inline void prefetch_read(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+	(void)address;
+#endif
+}
+
+// Чередование count поисков: в полете до BATCH_WINDOW поисков, каждый шаг продвигает
+// один поиск на одну ячейку или узел, адрес которой предвыбран предыдущим шагом,
+// поэтому промахи кэша разных ключей перекрываются, а не идут друг за другом.
+//   start(i, state) - начать i-й поиск: вычислить первый адрес и предвыбрать его
+//   step(state)     - сделать шаг и предвыбрать следующий адрес; true, если поиск завершен
+template <typename State, typename Start, typename Step>
+void interleave_lookups(size_t count, Start&& start, Step&& step) {
+	State window[BATCH_WINDOW];
+	bool busy[BATCH_WINDOW] = {};
+
+	size_t next = 0;
+	size_t active = 0;
+	for (; active < BATCH_WINDOW && next < count; ++active, ++next) {
+		start(next, window[active]);
+		busy[active] = true;
+	}
+	while (active != 0) {
+		for (size_t w = 0; w < BATCH_WINDOW; ++w) {
+			if (!busy[w] || !step(window[w])) continue;
+			if (next < count) {
+				start(next++, window[w]);
+			}
+			else {
+				busy[w] = false;
+				--active;
+			}
+		}
+	}
+}
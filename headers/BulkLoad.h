@@ -0,0 +1,122 @@
+﻿#pragma once
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <algorithm>
+
+// Инструменты параллельной загрузки (insert_bulk) и рехэширования: элементы хешируются
+// параллельно, разбиваются по диапазонам ячеек таблицы, и каждый поток заполняет
+// только свой диапазон - без блокировок и без гонок
+
+constexpr size_t BULK_MIN_ITEMS = 1 << 14;   //элементов на поток; меньше - загрузка в одном потоке
+constexpr size_t BULK_MIN_REGION = 1 << 12;  //ячеек (бакетов) в диапазоне одного потока
+constexpr size_t BULK_SKIP = static_cast<size_t>(-1); //ячейка элемента, не попадающего ни в один диапазон
+
+// Число потоков загрузки: requested (0 - по числу ядер), но не больше, чем позволяют
+// число элементов и размер таблицы
+inline size_t bulk_threads(size_t items, size_t slots, size_t requested) {
+	size_t threads = requested ? requested : std::thread::hardware_concurrency();
+	threads = std::min(threads, items / BULK_MIN_ITEMS);
+	threads = std::min(threads, slots / BULK_MIN_REGION);
+	return std::max<size_t>(threads, 1);
+}
+
+// Границы part-й из parts почти равных частей последовательности из count элементов
+inline size_t bulk_bound(size_t count, size_t parts, size_t part) {
+	return count / parts * part + std::min(part, count % parts);
+}
+
+// Номер части, в которую попадает index (обратное к bulk_bound): первые count % parts
+// частей на элемент длиннее остальных
+inline size_t bulk_part(size_t count, size_t parts, size_t index) {
+	size_t length = count / parts;
+	size_t split = (count % parts) * (length + 1);
+	return index < split ? index / (length + 1) : count % parts + (index - split) / length;
+}
+
+// task(0) ... task(parts - 1) в parts потоках (task(0) - в вызывающем).
+// Ждет завершения всех и пробрасывает первое исключение
+template <typename Task>
+void run_parallel(size_t parts, Task&& task) {
+	std::vector<std::exception_ptr> errors(parts);
+	auto run = [&](size_t part) {
+		try {
+			task(part);
+		}
+		catch (...) {
+			errors[part] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(parts);
+	try {
+		for (size_t part = 1; part < parts; ++part) {
+			threads.emplace_back(run, part);
+		}
+	}
+	catch (...) {
+		for (std::thread& thread : threads) thread.join();
+		throw;
+	}
+	run(0);
+	for (std::thread& thread : threads) thread.join();
+	for (const std::exception_ptr& error : errors) {
+		if (error) std::rethrow_exception(error);
+	}
+}
+
+// Разбиение элементов по диапазонам ячеек: диапазон part - ячейки
+// [bulk_bound(slots, parts, part), bulk_bound(slots, parts, part + 1))
+struct BulkPartition {
+	std::vector<size_t> order;  //номера элементов, сгруппированные по диапазонам
+	std::vector<size_t> bounds; //элементы диапазона part - order[bounds[part], bounds[part + 1])
+};
+
+// Устойчивая параллельная сортировка подсчетом по диапазону ячейки slot(i) элемента i
+// (BULK_SKIP - элемент пропускается): внутри диапазона элементы идут в исходном
+// порядке, поэтому из повторяющихся ключей поток встречает первым самый ранний
+template <typename Slot>
+BulkPartition partition_by_slot(size_t count, size_t slots, size_t parts, Slot&& slot) {
+	BulkPartition result;
+	if (parts == 1) { // один диапазон - исходный порядок
+		result.order.reserve(count);
+		for (size_t i = 0; i != count; ++i) {
+			if (slot(i) != BULK_SKIP) result.order.push_back(i);
+		}
+		result.bounds = { 0, result.order.size() };
+		return result;
+	}
+
+	// counts[chunk * parts + part] - элементов диапазона part в куске chunk
+	std::vector<size_t> counts(parts * parts, 0);
+	run_parallel(parts, [&](size_t chunk) {
+		for (size_t i = bulk_bound(count, parts, chunk); i != bulk_bound(count, parts, chunk + 1); ++i) {
+			size_t s = slot(i);
+			if (s != BULK_SKIP) ++counts[chunk * parts + bulk_part(slots, parts, s)];
+		}
+	});
+
+	result.bounds.assign(parts + 1, 0);
+	size_t offset = 0;
+	for (size_t part = 0; part != parts; ++part) {
+		result.bounds[part] = offset;
+		for (size_t chunk = 0; chunk != parts; ++chunk) {
+			size_t n = counts[chunk * parts + part];
+			counts[chunk * parts + part] = offset; // теперь - место записи куска chunk
+			offset += n;
+		}
+	}
+	result.bounds[parts] = offset;
+
+	result.order.resize(offset);
+	run_parallel(parts, [&](size_t chunk) {
+		size_t* next = &counts[chunk * parts];
+		for (size_t i = bulk_bound(count, parts, chunk); i != bulk_bound(count, parts, chunk + 1); ++i) {
+			size_t s = slot(i);
+			if (s != BULK_SKIP) result.order[next[bulk_part(slots, parts, s)]++] = i;
+		}
+	});
+	return result;
+}
@@ -2,175 +2,186 @@
 #include "IHashTable.h"
 #include <iostream>
 #include <vector>
-#include <list>
+#include <utility>
+#include "NodePool.h"
+#include "SizePolicy.h"
+#include "BatchLookup.h"
+#include "TableStats.h"
+#include "BulkLoad.h"
+#include "FrozenHashTable.h"
 #include <stdexcept>
+#include <algorithm>
 
-template <typename K, typename V> requires HashableKey<K>
-class ChainHashTable : public IHashTable<K,V> {	
+template <typename K, typename V, typename SizePolicy = ModuloSizePolicy,
+	typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>, typename Stats = NoStats,
+	typename Allocator = std::allocator<std::pair<const K, V>>>
+	requires KeyHasher<Hash, K> && KeyEquality<KeyEqual, K> && StatsPolicy<Stats>
+class ChainHashTable final : public IHashTable<K,V> {	
 		
 public:
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using allocator_type = Allocator;
+	using typename IHashTable<K, V>::Position;
+
 	//----------- Конструкторы -------------------//
 	ChainHashTable() = delete;
-	explicit ChainHashTable(size_t bucket_count) :	table(bucket_count) {
+	explicit ChainHashTable(size_t bucket_count, double mlf = 1.0, double growth = 2.0)
+		: table(SizePolicy::round_size(bucket_count), nullptr), max_load_factor(mlf), growth_factor(growth) {
 		
 		if (!bucket_count) 
 			throw std::invalid_argument("Hash table size must be positive");
+		if (mlf <= 0)
+			throw std::invalid_argument("Max load factor must be positive");
+		if (growth <= 1)
+			throw std::invalid_argument("Growth factor must be greater than 1");
+		policy.set(table.size());
 	}
 
-	ChainHashTable(const ChainHashTable&) = default;
-	ChainHashTable(ChainHashTable&&) = default;
-	ChainHashTable& operator=(const ChainHashTable&) = default;
-	ChainHashTable& operator=(ChainHashTable&&) = default;
-	virtual ~ChainHashTable() = default;
+	ChainHashTable(const ChainHashTable& other)
+		: table(other.table.size(), nullptr),
+		policy(other.policy),
+		max_load_factor(other.max_load_factor),
+		growth_factor(other.growth_factor),
+		element_count(other.element_count),
+		counters(other.counters) {
+
+		pool.reserve(other.element_count);
+		for (size_t i = 0; i < other.table.size(); ++i) {
+			// сохраняем порядок узлов в цепочке
+			Node** tail = &table[i];
+			for (const Node* node = other.table[i]; node; node = node->next) {
+				*tail = pool.create(nullptr, node->key, node->value);
+				tail = &(*tail)->next;
+			}
+		}
+	}
+	ChainHashTable(ChainHashTable&& other) noexcept
+		: table(std::move(other.table)),
+		pool(std::move(other.pool)),
+		policy(other.policy),
+		max_load_factor(other.max_load_factor),
+		growth_factor(other.growth_factor),
+		element_count(std::exchange(other.element_count, 0)),
+		counters(other.counters)
+	{}
+
+	ChainHashTable& operator=(const ChainHashTable& other) {
+		if (this != &other) {
+			ChainHashTable copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+	ChainHashTable& operator=(ChainHashTable&& other) noexcept {
+		if (this != &other) {
+			destroy_nodes();
+			table = std::move(other.table);
+			pool = std::move(other.pool);
+			policy = other.policy;
+			max_load_factor = other.max_load_factor;
+			growth_factor = other.growth_factor;
+			element_count = std::exchange(other.element_count, 0);
+			counters = other.counters;
+		}
+		return *this;
+	}
+	virtual ~ChainHashTable() { destroy_nodes(); }
 
 	//---------- Основные операции-------------------//
 	//Операции вставки
 	bool insert(K key, const V& value) override {
-		
-		size_t bucket_idx = std::hash<K>{}(key) % table.size(); 
-		auto& bucket = table[bucket_idx];
-
-		for (auto& [k, v] : bucket) {
-			if (k == key) {
-				return false; // Ключ уже есть, вставка не удалась
-			}
-		}
-		
-		// Ключа нет - добавляем
-		bucket.emplace_back(std::pair<K,V>{ key, value });
-		return true;		
+		return insert_impl(std::move(key), value);
 	}
 
 	bool insert(K key, V&& value) override {
+		return insert_impl(std::move(key), std::move(value));
+	}
 
-		size_t bucket_idx = std::hash<K>{}(key) % table.size();
-		auto& bucket = table[bucket_idx];
+	bool insert_or_assign(K key, const V& value) override {
+		return assign_impl(std::move(key), value);
+	}
 
-		for (auto& [k, v] : bucket) {
-			if (k == key) {
-				return false; // Ключ уже есть, вставка не удалась
-			}
-		}
+	bool insert_or_assign(K key, V&& value) override {
+		return assign_impl(std::move(key), std::move(value));
+	}
 
-		// Ключа нет - добавляем
-		bucket.emplace_back(std::pair<K, V>{ key, value });
-		return true;
+	//вставка со значением, построенным на месте из args; если ключ уже есть,
+	//значение не создается и args не трогаются. Возвращает {значение, вставлено ли}
+	template<typename... Args> requires std::constructible_from<V, Args...>
+	std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+		auto [node, inserted] = emplace_impl(key, std::forward<Args>(args)...);
+		return { &node->value, inserted };
+	}
+
+	template<typename... Args> requires std::constructible_from<V, Args...>
+	std::pair<V*, bool> try_emplace(K&& key, Args&&... args) {
+		auto [node, inserted] = emplace_impl(std::move(key), std::forward<Args>(args)...);
+		return { &node->value, inserted };
+	}
+
+	//то же, но ключ строится из любого подходящего аргумента (один раз, до поиска)
+	template<typename KArg, typename... Args>
+		requires std::constructible_from<K, KArg> && std::constructible_from<V, Args...>
+	std::pair<V*, bool> emplace(KArg&& key, Args&&... args) {
+		return try_emplace(K(std::forward<KArg>(key)), std::forward<Args>(args)...);
 	}
 
 	//операции удаления
 	bool remove(const K& key) override {
-		size_t bucket_idx = std::hash<K>{}(key) % table.size();
-		auto& bucket = table[bucket_idx];
-
-		for (auto it = bucket.begin(); it != bucket.end(); ) {
-			if (it->first == key) {
-				it = bucket.erase(it);
-				return true;
-			}
-			else {
-				++it;
-			}
-		}
-		return false;
+		return remove_impl(key);
 	}
 
 	//операции доступа и поиска
 	bool contains(const K& key) const override {
-		size_t bucket_idx = std::hash<K>{}(key) % table.size();
-		const std::list<std::pair<K, V>>& bucket = table[bucket_idx];		
-		for (auto& [k, v] : bucket) {
-			if (k == key) {
-				return true;
-			}
-		}
-		return false;
+		return find_node(key) != nullptr;
 	}
 
 	V* find(const K& key) override {
-		
-		size_t index = std::hash<K>{}(key) % table.size();		
-		for (auto& [k, v] : table[index]) {
-			if (k == key) {
-				return &v;
-			}
-		}
-		return nullptr;
+		Node* node = find_node(key);
+		return node ? &node->value : nullptr;
 	}
 	
 	const V* find(const K& key) const override {
-		
-		size_t index = std::hash<K>{}(key) % table.size();
-		for (auto& [k, v] : table[index]) {
-			if (k == key) {
-				return &v;
-			}
-		}
-		return nullptr;
+		const Node* node = find_node(key);
+		return node ? &node->value : nullptr;
 	}
 	
 	
 	V& at(const K& key) override {
-		
-		size_t index = std::hash<K>{}(key) % table.size();
-		for (auto& [k, v] : table[index]) {
-			if (k == key) {
-				return v;
-			}
-		}
-		throw std::out_of_range("Key not found in hash table");
-	
+		Node* node = find_node(key);
+		if (!node) throw std::out_of_range("Key not found in hash table");
+		return node->value;
 	};  
 	
 	const V& at(const K& key) const override {
-		
-		size_t index = std::hash<K>{}(key) % table.size();
-		for (auto& [k, v] : table[index]) {
-			if (k == key) {
-				return v;
-			}
-		}
-		throw std::out_of_range("Key not found in hash table");
+		const Node* node = find_node(key);
+		if (!node) throw std::out_of_range("Key not found in hash table");
+		return node->value;
 	}
 
 	// Только для неконстантных объектов
 	V& operator[](const K& key) override {
-		size_t index = std::hash<K>{}(key) % table.size();
-		for (auto& [k, v] : table[index]) {
-			if (k == key) {
-				return v;
-			}
-		}		
-		auto& new_pair = table[index].emplace_back(key, V{});
-		return new_pair.second;
+		return emplace_impl(key).first->value;
 	}
 
 	//очистка
 	void clear() override {
-		std::vector<std::list<std::pair<K, V>>> new_table(table.size());
-		table = std::move(new_table);
+		destroy_nodes(); // память узлов остается в пуле для повторного использования
 	}
 
 	//---------- Рехэширование -------------------//
 	void rehash(size_t new_size) override {
-		if (new_size < size()) {
-			throw std::invalid_argument("rehash: new size too small");
-		}
-		if (new_size == table.size()) return;
-
-		std::vector<std::list<std::pair<K, V>>> new_table(new_size);
-
-		for (std::list<std::pair<K, V>>& bucket : table) {
-			while (!bucket.empty()) {
-				K key = std::move(bucket.front().first);
-				V value = std::move(bucket.front().second);
-				bucket.pop_front();
+		rehash(new_size, 0);
+	}
 
-				size_t index = std::hash<K>{}(key) % new_size;
-				new_table[index].emplace_back(std::move(key), std::move(value));
-			}
+	// То же в threads потоках; 0 - автоматически: по числу ядер, но не больше
+	// одного потока на BULK_MIN_ITEMS элементов (у небольшой таблицы - в одном)
+	void rehash(size_t new_size, size_t threads) {
+		if (new_size < element_count) {
+			throw std::invalid_argument("rehash: new size too small");
 		}
-
-		table = std::move(new_table);
+		rebuild(new_size, threads);
 	}
 
 	
@@ -181,21 +192,460 @@ public:
 
 	//фактический размер
 	size_t size() const noexcept {
-		size_t total = 0;
-		for (const auto& bucket : table) {
-			total += bucket.size();
-		}
-		return total;
+		return element_count;
 	}
 	//проверка на пустоту
-	bool empty() const noexcept override { return size() == 0; }
+	bool empty() const noexcept override { return element_count == 0; }
 
 	// Коэффициент заполнения
 	double load_factor() const override {
-		return static_cast<double>(size()) / table.size();
+		return static_cast<double>(element_count) / table.size();
+	}
+
+	//максимальный коэффициент заполнения
+	double get_max_load_factor() const { return max_load_factor; }
+
+	//сводка: длины цепочек и пустые бакеты; гистограммы и счетчики - при Stats = CountingStats
+	TableStats stats() const {
+		TableStats result;
+		result.size = element_count;
+		result.buckets = table.size();
+		result.load_factor = load_factor();
+		for (const Node* head : table) {
+			size_t length = 0;
+			for (const Node* node = head; node; node = node->next) ++length;
+			if (length == 0) ++result.empty_buckets;
+			result.max_chain_length = std::max(result.max_chain_length, length);
+		}
+		result.empty_bucket_ratio = static_cast<double>(result.empty_buckets) / table.size();
+		size_t chains = table.size() - result.empty_buckets;
+		result.average_chain_length = chains ? static_cast<double>(element_count) / chains : 0.0;
+		counters.report(result);
+		return result;
+	}
+
+	//обнуление счетчиков статистики
+	void reset_stats() { counters.reset(); }
+
+	//байт памяти таблицы: сам объект, массив бакетов и блоки пула узлов
+	//(память, которой владеют ключи и значения, например буферы строк, не учитывается)
+	size_t memory_usage() const noexcept {
+		return sizeof(*this) + table.capacity() * sizeof(Node*) + pool.memory_usage();
+	}
+
+	//---------- Поиск по ключу другого типа -------------------//
+	// Доступен при прозрачных Hash и KeyEqual: например, std::string-ключ
+	// ищется по std::string_view или const char* без временной строки
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	bool remove(const Q& key) { return remove_impl(key); }
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	bool contains(const Q& key) const { return find_node(key) != nullptr; }
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	V* find(const Q& key) {
+		Node* node = find_node(key);
+		return node ? &node->value : nullptr;
+	}
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	const V* find(const Q& key) const {
+		const Node* node = find_node(key);
+		return node ? &node->value : nullptr;
+	}
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	V& at(const Q& key) {
+		Node* node = find_node(key);
+		if (!node) throw std::out_of_range("Key not found in hash table");
+		return node->value;
+	}
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	const V& at(const Q& key) const {
+		const Node* node = find_node(key);
+		if (!node) throw std::out_of_range("Key not found in hash table");
+		return node->value;
+	}
+
+	//---------- Обход -------------------//
+	// Позиция - бакет и узел цепочки
+	Position first_position() const override { return chain_from(0); }
+
+	Position next_position(Position at) const override {
+		const Node* node = static_cast<const Node*>(at.node)->next;
+		return node ? Position{ at.slot, node } : chain_from(at.slot + 1);
+	}
+
+	std::pair<const K*, const V*> entry_at(Position at) const override {
+		const Node* node = static_cast<const Node*>(at.node);
+		return { &node->key, &node->value };
+	}
+
+	//---------- Пакетные операции -------------------//
+	void find_batch(std::span<const K> keys, std::span<V*> results) override {
+		this->check_batch(keys.size(), results.size());
+		lookup_batch(keys, [&](size_t i, Node* node) { results[i] = node ? &node->value : nullptr; });
+	}
+
+	void find_batch(std::span<const K> keys, std::span<const V*> results) const override {
+		this->check_batch(keys.size(), results.size());
+		lookup_batch(keys, [&](size_t i, const Node* node) { results[i] = node ? &node->value : nullptr; });
+	}
+
+	size_t contains_batch(std::span<const K> keys, std::span<bool> results) const override {
+		this->check_batch(keys.size(), results.size());
+		size_t found = 0;
+		lookup_batch(keys, [&](size_t i, const Node* node) {
+			results[i] = node != nullptr;
+			found += results[i];
+		});
+		return found;
+	}
+
+	//головы цепочек блока предвыбираются до вставок
+	size_t insert_batch(std::span<const std::pair<K, V>> items) override {
+		size_t inserted = 0;
+		for (size_t begin = 0; begin < items.size(); begin += BATCH_BLOCK) {
+			size_t end = std::min(begin + BATCH_BLOCK, items.size());
+			for (size_t i = begin; i < end; ++i) {
+				prefetch_read(&table[bucket_of(items[i].first)]);
+			}
+			for (size_t i = begin; i < end; ++i) {
+				inserted += insert_impl(items[i].first, items[i].second);
+			}
+		}
+		return inserted;
+	}
+
+	//---------- Заморозка -------------------//
+	// Неизменяемая копия с минимальным совершенным хешированием (FrozenHashTable.h):
+	// каждый поиск - одна ячейка и одно сравнение. Таблица остается как была
+	FrozenHashTable<K, V, Hash, KeyEqual> freeze() const {
+		std::vector<std::pair<K, V>> items;
+		items.reserve(size());
+		for (Position at = first_position(); at != Position{}; at = next_position(at)) {
+			auto [key, value] = entry_at(at);
+			items.emplace_back(*key, *value);
+		}
+		return FrozenHashTable<K, V, Hash, KeyEqual>(std::move(items));
+	}
+
+	//---------- Параллельная загрузка -------------------//
+	// Вставка items в threads потоках (0 - по числу ядер) с тем же результатом, что
+	// insert каждого элемента по порядку: из повторяющихся ключей вставляется первый,
+	// значения уже имеющихся ключей не меняются. Таблица заранее растет под все элементы,
+	// каждый поток заполняет свой диапазон бакетов. Возвращает число вставленных
+	size_t insert_bulk(std::span<const std::pair<K, V>> items, size_t threads = 0) {
+		size_t needed = static_cast<size_t>((element_count + items.size()) / max_load_factor) + 1;
+		if (needed > table.size()) rebuild(needed, 0);
+
+		const size_t count = items.size();
+		const size_t parts = bulk_threads(count, table.size(), threads);
+		std::vector<size_t> buckets(count);
+		run_parallel(parts, [&](size_t part) {
+			for (size_t i = bulk_bound(count, parts, part); i != bulk_bound(count, parts, part + 1); ++i) {
+				buckets[i] = bucket_of(items[i].first);
+			}
+		});
+		BulkPartition partition = partition_by_slot(count, table.size(), parts, [&](size_t i) { return buckets[i]; });
+
+		// память узлов выделяется здесь, потоки только строят узлы в своих пулах
+		std::vector<NodePool<Node, Rebind<Node>>> pools(parts);
+		for (size_t part = 0; part != parts; ++part) {
+			pools[part].reserve(partition.bounds[part + 1] - partition.bounds[part]);
+		}
+		pool.reserve_slabs(parts);
+		std::vector<size_t> inserted(parts, 0);
+
+		// узлы переходят в пул таблицы и после исключения в одном из потоков
+		auto collect = [&]() {
+			size_t total = 0;
+			for (size_t part = 0; part != parts; ++part) {
+				pool.merge(std::move(pools[part]));
+				total += inserted[part];
+			}
+			element_count += total;
+			for (size_t i = 0; i != total; ++i) counters.on_insert();
+			return total;
+		};
+		try {
+			run_parallel(parts, [&](size_t part) {
+				for (size_t k = partition.bounds[part]; k != partition.bounds[part + 1]; ++k) {
+					size_t i = partition.order[k];
+					Node*& head = table[buckets[i]];
+					bool present = false;
+					for (const Node* node = head; node && !present; node = node->next) {
+						present = KeyEqual{}(node->key, items[i].first);
+					}
+					if (!present) {
+						head = pools[part].create(head, items[i].first, items[i].second);
+						++inserted[part];
+					}
+				}
+			});
+		}
+		catch (...) {
+			collect();
+			throw;
+		}
+		return collect();
+	}
+
+private:
+	struct Node { //узел односвязной цепочки
+		Node* next;
+		K key;
+		V value;
+
+		template<typename KFwd, typename... Args>
+		Node(Node* n, KFwd&& k, Args&&... args)
+			: next(n),
+			key(std::forward<KFwd>(k)),
+			value(std::forward<Args>(args)...) {
+		}
+	};
+
+	template<typename T>
+	using Rebind = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+	using BucketVector = std::vector<Node*, Rebind<Node*>>;
+
+	//индекс бакета для ключа (K или прозрачно сравнимого с ним типа)
+	template<typename Q>
+	size_t bucket_of(const Q& key) const {
+		return policy.index(Hash{}(key));
+	}
+
+	//поиск узла с ключом
+	template<typename Q>
+	Node* find_node(const Q& key) const {
+		size_t index = bucket_of(key);
+		size_t probes = 0;
+		for (Node* node = table[index]; node; node = node->next) {
+			++probes;
+			if (KeyEqual{}(node->key, key)) {
+				counters.on_lookup(probes, true);
+				return node;
+			}
+		}
+		counters.on_lookup(probes, false);
+		return nullptr;
+	}
+
+	//голова первой непустой цепочки начиная с бакета bucket
+	Position chain_from(size_t bucket) const {
+		for (; bucket < table.size(); ++bucket) {
+			if (table[bucket]) return { bucket, table[bucket] };
+		}
+		return {};
+	}
+
+	//удаление узла с ключом
+	template<typename Q>
+	bool remove_impl(const Q& key) {
+		size_t bucket_idx = bucket_of(key);
+
+		// указатель на ссылку, ведущую к текущему узлу - удаление без prev
+		for (Node** link = &table[bucket_idx]; *link; link = &(*link)->next) {
+			if (KeyEqual{}((*link)->key, key)) {
+				Node* node = *link;
+				*link = node->next;
+				pool.destroy(node);
+				--element_count;
+				counters.on_remove();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	//пакетный поиск: для блока ключей сначала хеши и предвыборка голов цепочек,
+	//затем чередующийся обход цепочек; emit(i, node) - результат для keys[i]
+	template<typename Emit>
+	void lookup_batch(std::span<const K> keys, Emit&& emit) const {
+		struct Lookup {
+			size_t index;  //номер ключа
+			Node* node;    //текущий узел цепочки (уже предвыбран)
+			size_t probes; //сравнений ключа
+		};
+		size_t buckets[BATCH_BLOCK];
+
+		for (size_t begin = 0; begin < keys.size(); begin += BATCH_BLOCK) {
+			size_t count = std::min(BATCH_BLOCK, keys.size() - begin);
+			for (size_t i = 0; i < count; ++i) {
+				buckets[i] = bucket_of(keys[begin + i]);
+				prefetch_read(&table[buckets[i]]);
+			}
+			interleave_lookups<Lookup>(count,
+				[&](size_t i, Lookup& lookup) {
+					lookup.index = begin + i;
+					lookup.node = table[buckets[i]];
+					lookup.probes = 0;
+					if (lookup.node) prefetch_read(lookup.node);
+				},
+				[&](Lookup& lookup) {
+					if (lookup.node) {
+						++lookup.probes;
+						if (!KeyEqual{}(lookup.node->key, keys[lookup.index])) {
+							lookup.node = lookup.node->next;
+							if (lookup.node) {
+								prefetch_read(lookup.node);
+								return false;
+							}
+						}
+					}
+					counters.on_lookup(lookup.probes, lookup.node != nullptr);
+					emit(lookup.index, lookup.node);
+					return true;
+				});
+		}
+	}
+
+	//внутренняя реализация вставки
+	template<typename VFwd>
+	bool insert_impl(K key, VFwd&& value) {
+		return emplace_impl(std::move(key), std::forward<VFwd>(value)).second;
+	}
+
+	//вставка или замена значения за один поиск
+	template<typename VFwd>
+	bool assign_impl(K key, VFwd&& value) {
+		auto [node, inserted] = emplace_impl(std::move(key), std::forward<VFwd>(value));
+		if (!inserted) node->value = std::forward<VFwd>(value); // value не тронут: узел не создавался
+		return inserted;
+	}
+
+	//поиск ключа и, если его нет, создание узла прямо в пуле: ключ и значение
+	//строятся один раз из key и args. Возвращает {узел с ключом, создан ли он}
+	template<typename KFwd, typename... Args>
+	std::pair<Node*, bool> emplace_impl(KFwd&& key, Args&&... args) {
+		size_t bucket_idx = bucket_of(key);
+		for (Node* node = table[bucket_idx]; node; node = node->next) {
+			if (KeyEqual{}(node->key, key)) {
+				return { node, false }; // Ключ уже есть, вставка не удалась
+			}
+		}
+
+		// Ключа нет - при необходимости растем и добавляем в голову цепочки
+		if (grow_if_needed()) {
+			bucket_idx = bucket_of(key);
+		}
+		table[bucket_idx] = pool.create(table[bucket_idx], std::forward<KFwd>(key), std::forward<Args>(args)...);
+		++element_count;
+		counters.on_insert();
+		return { table[bucket_idx], true };
+	}
+
+	//перевешивание узлов цепочки head в бакеты new_table
+	static void relink(Node* head, BucketVector& new_table, const SizePolicy& new_policy) {
+		while (head) {
+			Node* node = head;
+			head = node->next;
+
+			size_t index = new_policy.index(Hash{}(node->key));
+			node->next = new_table[index];
+			new_table[index] = node;
+		}
+	}
+
+	//перевешивание в parts потоках без дополнительной памяти: поток p снимает узлы со
+	//своего диапазона старых бакетов в списки по диапазонам новых (через next самих узлов),
+	//затем поток q собирает списки своего диапазона в новые цепочки. Если потоки
+	//запустить не удалось, оставшиеся узлы перевешиваются в текущем потоке
+	void relink_parallel(BucketVector& new_table, const SizePolicy& new_policy, size_t parts) {
+		std::vector<Node*> lists(parts * parts, nullptr); // lists[p * parts + q]
+		const size_t old_size = table.size();
+		const size_t new_size = new_table.size();
+		try {
+			run_parallel(parts, [&](size_t p) {
+				Node** heads = &lists[p * parts];
+				for (size_t b = bulk_bound(old_size, parts, p); b != bulk_bound(old_size, parts, p + 1); ++b) {
+					while (Node* node = table[b]) {
+						table[b] = node->next;
+						size_t q = bulk_part(new_size, parts, new_policy.index(Hash{}(node->key)));
+						node->next = heads[q];
+						heads[q] = node;
+					}
+				}
+			});
+			run_parallel(parts, [&](size_t q) {
+				for (size_t p = 0; p != parts; ++p) {
+					relink(std::exchange(lists[p * parts + q], nullptr), new_table, new_policy);
+				}
+			});
+		}
+		catch (...) { // потоки или память под них
+			for (Node*& bucket : table) {
+				relink(std::exchange(bucket, nullptr), new_table, new_policy);
+			}
+			for (Node*& list : lists) {
+				relink(std::exchange(list, nullptr), new_table, new_policy);
+			}
+		}
+	}
+
+	//автоматический рост перед добавлением нового узла; true, если таблица перестроена.
+	//Бакетов не меньше, чем нужно для max_load_factor: при max_load_factor больше
+	//growth_factor одного умножения на growth_factor не хватает
+	bool grow_if_needed() {
+		if (static_cast<double>(element_count + 1) / table.size() <= max_load_factor) {
+			return false;
+		}
+		size_t grown = static_cast<size_t>(table.size() * growth_factor);
+		size_t needed = static_cast<size_t>((element_count + 1) / max_load_factor) + 1;
+		rebuild(std::max({ grown, needed, table.size() + 1 }), 0);
+		return true;
+	}
+
+	//перестроение под new_size бакетов (без проверки размера: при max_load_factor > 1
+	//бакетов может быть меньше, чем элементов)
+	void rebuild(size_t new_size, size_t threads) {
+		new_size = SizePolicy::round_size(new_size);
+		if (new_size == table.size()) return;
+
+		[[maybe_unused]] auto timer = counters.rehash_timer();
+		counters.on_rehash();
+
+		BucketVector new_table(new_size, nullptr);
+		SizePolicy new_policy;
+		new_policy.set(new_size);
+
+		// узлы не пересоздаются - только перевешиваются в новые цепочки
+		size_t parts = bulk_threads(element_count, std::min(table.size(), new_size), threads);
+		if (parts > 1) {
+			relink_parallel(new_table, new_policy, parts);
+		}
+		else {
+			for (Node*& bucket : table) {
+				relink(std::exchange(bucket, nullptr), new_table, new_policy);
+			}
+		}
+
+		table = std::move(new_table);
+		policy = new_policy;
 	}
 
+	//уничтожение всех узлов (бакеты становятся пустыми)
+	void destroy_nodes() noexcept {
+		for (Node*& bucket : table) {
+			while (bucket) {
+				Node* node = bucket;
+				bucket = node->next;
+				pool.destroy(node);
+			}
+		}
+		element_count = 0;
+	}
 
 private:	
-	std::vector<std::list<std::pair<K,V>>> table;
+	BucketVector table;                //головы цепочек
+	NodePool<Node, Rebind<Node>> pool; //память узлов
+	SizePolicy policy;        //сведение хеша к индексу бакета
+
+	double max_load_factor;
+	double growth_factor;     //во сколько раз растет число бакетов
+
+	size_t element_count = 0; //количество элементов
+
+	[[no_unique_address]] mutable Stats counters; //статистика операций (NoStats - пусто)
 };
\ No newline at end of file
@@ -0,0 +1,314 @@
+﻿#pragma once
+#include "IHashTable.h"
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <shared_mutex>
+#include <mutex>
+#include <thread>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+#include <bit>
+#include <concepts>
+#include "Hashers.h"
+
+// Потокобезопасная обертка: ключи распределяются по N независимым
+// таблицам-шардам по старшим битам перемешанного хеша, у каждого шарда
+// своя блокировка читатель-писатель. Заголовки шардов выровнены по
+// строке кэша, чтобы блокировки разных шардов не делили одну строку.
+//
+// Указатели и ссылки, которые возвращают find/at/operator[], остаются
+// валидными только пока никто не изменяет тот же шард; при конкурентной
+// записи пользуйтесь get (копия значения) и visit (доступ под блокировкой)
+template <typename Table>
+	requires std::derived_from<Table, IHashTable<typename Table::key_type, typename Table::mapped_type>>
+class ConcurrentShardedHashTable final : public IHashTable<typename Table::key_type, typename Table::mapped_type> {
+
+	using K = typename Table::key_type;
+	using V = typename Table::mapped_type;
+	using typename IHashTable<K, V>::Position;
+
+public:
+	//----------- Конструкторы -------------------//
+	ConcurrentShardedHashTable() = delete;
+
+	// size - суммарный размер, table_args - остальные аргументы конструктора шарда
+	template <typename... Args>
+	explicit ConcurrentShardedHashTable(size_t size, size_t shards = default_shard_count(), Args&&... table_args) {
+
+		if (size == 0) throw std::invalid_argument("Size must be positive");
+		if (shards == 0) throw std::invalid_argument("Shard count must be positive");
+
+		shards = std::bit_ceil(shards);
+		shard_bits = std::countr_zero(shards);
+		size_t shard_size = (size + shards - 1) / shards;
+		for (size_t i = 0; i < shards; ++i) {
+			shard_list.push_back(std::make_unique<Shard>(shard_size, table_args...));
+		}
+	}
+
+	ConcurrentShardedHashTable(const ConcurrentShardedHashTable& other) : shard_bits(other.shard_bits) {
+		for (const auto& shard : other.shard_list) {
+			std::shared_lock lock(shard->mutex);
+			shard_list.push_back(std::make_unique<Shard>(shard->table));
+		}
+	}
+
+	ConcurrentShardedHashTable(ConcurrentShardedHashTable&& other) noexcept
+		: shard_list(std::move(other.shard_list)),
+		shard_bits(std::exchange(other.shard_bits, 0))
+	{}
+
+	ConcurrentShardedHashTable& operator=(const ConcurrentShardedHashTable& other) {
+		if (this != &other) {
+			ConcurrentShardedHashTable copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	ConcurrentShardedHashTable& operator=(ConcurrentShardedHashTable&& other) noexcept {
+		if (this != &other) {
+			shard_list = std::move(other.shard_list);
+			shard_bits = std::exchange(other.shard_bits, 0);
+		}
+		return *this;
+	}
+	virtual ~ConcurrentShardedHashTable() = default;
+
+	//---------- Основные операции-------------------//
+	//Операции вставки
+	bool insert(K key, const V& value) override {
+		Shard& shard = shard_for(key);
+		std::unique_lock lock(shard.mutex);
+		return shard.table.insert(std::move(key), value);
+	}
+
+	bool insert(K key, V&& value) override {
+		Shard& shard = shard_for(key);
+		std::unique_lock lock(shard.mutex);
+		return shard.table.insert(std::move(key), std::move(value));
+	}
+
+	//операции удаления
+	bool remove(const K& key) override {
+		Shard& shard = shard_for(key);
+		std::unique_lock lock(shard.mutex);
+		return shard.table.remove(key);
+	}
+
+	//операции доступа и поиска
+	bool contains(const K& key) const override {
+		const Shard& shard = shard_for(key);
+		std::shared_lock lock(shard.mutex);
+		return shard.table.contains(key);
+	}
+
+	V* find(const K& key) override {
+		Shard& shard = shard_for(key);
+		std::shared_lock lock(shard.mutex);
+		return shard.table.find(key);
+	}
+
+	const V* find(const K& key) const override {
+		const Shard& shard = shard_for(key);
+		std::shared_lock lock(shard.mutex);
+		return std::as_const(shard.table).find(key);
+	}
+
+	V& at(const K& key) override {
+		Shard& shard = shard_for(key);
+		std::shared_lock lock(shard.mutex);
+		return shard.table.at(key);
+	}
+
+	const V& at(const K& key) const override {
+		const Shard& shard = shard_for(key);
+		std::shared_lock lock(shard.mutex);
+		return std::as_const(shard.table).at(key);
+	}
+
+	// Только для неконстантных объектов
+	V& operator[](const K& key) override {
+		Shard& shard = shard_for(key);
+		std::unique_lock lock(shard.mutex);
+		return shard.table[key];
+	}
+
+	//копия значения, прочитанная под блокировкой
+	std::optional<V> get(const K& key) const {
+		const Shard& shard = shard_for(key);
+		std::shared_lock lock(shard.mutex);
+		const V* value = std::as_const(shard.table).find(key);
+		return value ? std::optional<V>(*value) : std::nullopt;
+	}
+
+	//вызов f(const V&) под разделяемой блокировкой шарда; false, если ключа нет
+	template <typename F>
+	bool visit(const K& key, F&& f) const {
+		const Shard& shard = shard_for(key);
+		std::shared_lock lock(shard.mutex);
+		const V* value = std::as_const(shard.table).find(key);
+		if (!value) return false;
+		std::forward<F>(f)(*value);
+		return true;
+	}
+
+	//вызов f(V&) под исключительной блокировкой шарда; false, если ключа нет
+	template <typename F>
+	bool visit(const K& key, F&& f) {
+		Shard& shard = shard_for(key);
+		std::unique_lock lock(shard.mutex);
+		V* value = shard.table.find(key);
+		if (!value) return false;
+		std::forward<F>(f)(*value);
+		return true;
+	}
+
+	//очистка
+	void clear() override {
+		for (auto& shard : shard_list) {
+			std::unique_lock lock(shard->mutex);
+			shard->table.clear();
+		}
+	}
+
+	//---------- Рехэширование -------------------//
+	// Новый суммарный размер делится поровну между шардами
+	void rehash(size_t new_size) override {
+		size_t shard_size = (new_size + shard_list.size() - 1) / shard_list.size();
+		for (auto& shard : shard_list) {
+			std::unique_lock lock(shard->mutex);
+			if (shard_size > shard->table.max_bucket_count()) {
+				shard->table.rehash(shard_size);
+			}
+		}
+	}
+
+	//---------- Характeристики-------------------//
+
+	//максимальное число бакетов (сумма по шардам)
+	[[nodiscard]] size_t max_bucket_count() const noexcept override {
+		return aggregate([](const Table& table) { return table.max_bucket_count(); });
+	}
+
+	//фактический размер (сумма по шардам; при конкурентной записи - приблизительный)
+	size_t size() const noexcept override {
+		return aggregate([](const Table& table) { return table.size(); });
+	}
+
+	//проверка на пустоту
+	bool empty() const noexcept override { return size() == 0; }
+
+	// Коэффициент заполнения
+	double load_factor() const override {
+		size_t buckets = max_bucket_count();
+		return buckets ? static_cast<double>(size()) / buckets : 0.0;
+	}
+
+	//максимальный коэффициент заполнения шардов
+	double get_max_load_factor() const requires requires(const Table& t) { t.get_max_load_factor(); } {
+		return shard_list.front()->table.get_max_load_factor();
+	}
+
+	//байт памяти: обертка, заголовки шардов и сами таблицы
+	size_t memory_usage() const requires requires(const Table& t) { t.memory_usage(); } {
+		size_t shards = shard_list.capacity() * sizeof(std::unique_ptr<Shard>)
+			+ shard_list.size() * (sizeof(Shard) - sizeof(Table));
+		return sizeof(*this) + shards + aggregate([](const Table& table) { return table.memory_usage(); });
+	}
+
+	//среднее число проб до ключа, взвешенное по числу ключей шардов
+	double average_probe_length() const requires requires(const Table& t) { t.average_probe_length(); } {
+		double probes = 0;
+		size_t count = 0;
+		for (const auto& shard : shard_list) {
+			std::shared_lock lock(shard->mutex);
+			probes += shard->table.average_probe_length() * shard->table.size();
+			count += shard->table.size();
+		}
+		return count ? probes / count : 0.0;
+	}
+
+	//число шардов
+	size_t shard_count() const noexcept { return shard_list.size(); }
+
+	//---------- Обход -------------------//
+	// Позиция - номер шарда в старших битах ячейки и позиция внутри шарда.
+	// Обход идет без блокировок: шарды нельзя изменять, пока он идет
+	Position first_position() const override {
+		if (shard_list.empty()) return {};
+		return shard_position(0, shard_list.front()->table.first_position());
+	}
+
+	Position next_position(Position at) const override {
+		size_t shard = shard_bits ? at.slot >> (64 - shard_bits) : 0;
+		Position inner{ at.slot & inner_mask(), at.node };
+		return shard_position(shard, shard_list[shard]->table.next_position(inner));
+	}
+
+	std::pair<const K*, const V*> entry_at(Position at) const override {
+		size_t shard = shard_bits ? at.slot >> (64 - shard_bits) : 0;
+		return shard_list[shard]->table.entry_at({ at.slot & inner_mask(), at.node });
+	}
+
+	//число шардов по умолчанию: несколько на ядро, чтобы потоки реже сталкивались
+	static size_t default_shard_count() {
+		size_t cores = std::thread::hardware_concurrency();
+		return std::bit_ceil((cores ? cores : 1) * 4);
+	}
+
+private:
+	static constexpr size_t CACHE_LINE = 64;
+
+	struct alignas(CACHE_LINE) Shard { //заголовок шарда на отдельной строке кэша
+		template <typename... Args>
+		explicit Shard(Args&&... args) : table(std::forward<Args>(args)...) {}
+
+		mutable std::shared_mutex mutex;
+		Table table;
+	};
+
+	//шард по младшим битам хеша, отдельно перемешанного wy_mix. Таблицы внутри шарда
+	//берут ячейку из того же хеша (PowerOfTwoSizePolicy - старшие биты произведения
+	//на 2^64/φ, Modulo и Prime - остаток, Swiss и Cuckoo - murmur_mix), и с этими
+	//битами номер шарда не связан: ключи шарда ложатся по всем его ячейкам
+	const Shard& shard_for(const K& key) const {
+		if (shard_bits == 0) return *shard_list.front();
+		uint64_t hash = wy_mix(static_cast<uint64_t>(typename Table::hasher{}(key)) ^ WY_P0, WY_P1);
+		return *shard_list[static_cast<size_t>(hash & (shard_list.size() - 1))];
+	}
+	Shard& shard_for(const K& key) {
+		return const_cast<Shard&>(std::as_const(*this).shard_for(key));
+	}
+
+	//биты ячейки, отведенные под позицию внутри шарда
+	size_t inner_mask() const { return static_cast<size_t>(-1) >> shard_bits; }
+
+	//позиция inner шарда shard; если шард пройден - первая позиция следующих
+	Position shard_position(size_t shard, Position inner) const {
+		while (inner == Position{}) {
+			if (++shard == shard_list.size()) return {};
+			inner = shard_list[shard]->table.first_position();
+		}
+		size_t high = shard_bits ? shard << (64 - shard_bits) : 0;
+		return { high | inner.slot, inner.node };
+	}
+
+	//сумма характеристики по шардам, каждый под разделяемой блокировкой
+	template <typename F>
+	size_t aggregate(F&& f) const {
+		size_t total = 0;
+		for (const auto& shard : shard_list) {
+			std::shared_lock lock(shard->mutex);
+			total += f(shard->table);
+		}
+		return total;
+	}
+
+private:
+	std::vector<std::unique_ptr<Shard>> shard_list;
+	int shard_bits = 0; //log2 числа шардов
+};
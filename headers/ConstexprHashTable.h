@@ -0,0 +1,158 @@
+﻿#pragma once
+#include "IHashTable.h"
+#include <array>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <stdexcept>
+#include "SizePolicy.h"
+#include "Hashers.h"
+
+// Хеш по умолчанию для ConstexprHashTable: std::hash не constexpr, поэтому
+// для целых и перечислений - WyHash, для строк (std::string_view) - StringHash
+template <typename K>
+struct ConstexprHashFor {};
+
+template <typename K> requires std::is_integral_v<K> || std::is_enum_v<K>
+struct ConstexprHashFor<K> { using type = WyHash<K>; };
+
+template <typename K> requires std::is_convertible_v<const K&, std::string_view>
+struct ConstexprHashFor<K> { using type = StringHash; };
+
+template <typename K>
+using ConstexprHash = typename ConstexprHashFor<K>::type;
+
+// Число ячеек для count ключей: заполнение меньше 1/2, при котором квадратичный
+// пробинг OpenHashTable находит свободную ячейку при любой политике размера
+template <typename SizePolicy>
+constexpr size_t constexpr_table_capacity(size_t count, size_t a = 0, size_t b = 1) {
+	return ProbeScheme<SizePolicy>::valid_grow_size(2 * count + 1, a, b);
+}
+
+// Таблица с открытой адресацией фиксированной емкости Capacity, которую целиком
+// строит компилятор: ключи раскладываются той же схемой пробинга, что в OpenHashTable
+// (ProbeScheme<SizePolicy> с коэффициентами A и B), а constexpr-объект лежит в данных
+// только для чтения и не строится при запуске. Поиск по константному ключу
+// сводится к константе. Удобнее создавать через make_constexpr_table.
+// K и V - литеральные типы с конструктором по умолчанию (для пустых ячеек),
+// Hash - constexpr хеш-функция
+template <typename K, typename V, size_t Capacity, typename SizePolicy = ModuloSizePolicy,
+	typename Hash = ConstexprHash<K>, typename KeyEqual = std::equal_to<K>>
+	requires KeyHasher<Hash, K> && KeyEquality<KeyEqual, K>
+class ConstexprHashTable {
+
+public:
+	using key_type = K;
+	using mapped_type = V;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using Position = TablePosition;
+
+	//----------- Конструкторы -------------------//
+	// Вставка всех пар; повтор ключа или нехватка ячеек - исключение
+	// (при вычислении на этапе компиляции - ошибка компиляции)
+	constexpr explicit ConstexprHashTable(std::span<const std::pair<K, V>> items, size_t a = 0, size_t b = 1)
+		: scheme(Capacity, a, b) {
+		if (SizePolicy::round_size(Capacity) != Capacity) {
+			throw std::invalid_argument("Capacity is not a valid size for the size policy");
+		}
+		if ((a == 0 && b == 0) || (a != 0 && std::gcd(a, Capacity) != 1) || (b != 0 && std::gcd(b, Capacity) != 1)) {
+			throw std::invalid_argument("A and B must be coprime with the capacity, not both zero");
+		}
+		for (const auto& [key, value] : items) {
+			insert(key, value);
+		}
+	}
+
+	//---------- Поиск -------------------//
+	constexpr bool contains(const K& key) const { return find_slot(key) != NPOS; }
+
+	constexpr const V* find(const K& key) const {
+		size_t slot = find_slot(key);
+		return slot != NPOS ? &cells[slot].value : nullptr;
+	}
+
+	constexpr const V& at(const K& key) const {
+		size_t slot = find_slot(key);
+		if (slot == NPOS) throw std::out_of_range("Key not found in hash table");
+		return cells[slot].value;
+	}
+
+	// Значение или fallback: удобно в константных выражениях
+	constexpr V value_or(const K& key, V fallback) const {
+		size_t slot = find_slot(key);
+		return slot != NPOS ? cells[slot].value : fallback;
+	}
+
+	//---------- Характеристики -------------------//
+	constexpr size_t size() const noexcept { return count; }
+	constexpr bool empty() const noexcept { return count == 0; }
+	constexpr size_t max_bucket_count() const noexcept { return Capacity; }
+	constexpr double load_factor() const { return static_cast<double>(count) / Capacity; }
+
+	//---------- Обход -------------------//
+	constexpr Position first_position() const { return active_from(0); }
+	constexpr Position next_position(Position at) const { return active_from(at.slot + 1); }
+
+	constexpr std::pair<const K*, const V*> entry_at(Position at) const {
+		const Cell& cell = cells[at.slot];
+		return { &cell.key, &cell.value };
+	}
+
+private:
+	struct Cell {
+		K key{};
+		V value{};
+		bool active = false;
+	};
+
+	static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+	// Поиск ячейки с ключом (номер, а не указатель: указатели на статические
+	// объекты функций не везде сравниваются в константных выражениях)
+	constexpr size_t find_slot(const K& key) const {
+		ProbeSequence seq = scheme.start(Hash{}(key));
+		for (size_t i = 0; i < Capacity; ++i, seq.next()) {
+			const Cell& cell = cells[seq.index()];
+			if (!cell.active) return NPOS; // удалений нет: пустая ячейка - конец цепочки
+			if (KeyEqual{}(cell.key, key)) return seq.index();
+		}
+		return NPOS;
+	}
+
+	constexpr void insert(const K& key, const V& value) {
+		ProbeSequence seq = scheme.start(Hash{}(key));
+		for (size_t i = 0; i < Capacity; ++i, seq.next()) {
+			Cell& cell = cells[seq.index()];
+			if (!cell.active) {
+				cell = Cell{ key, value, true };
+				++count;
+				return;
+			}
+			if (KeyEqual{}(cell.key, key)) throw std::invalid_argument("Duplicate key in constexpr table");
+		}
+		throw std::length_error("Constexpr table capacity is too small");
+	}
+
+	constexpr Position active_from(size_t slot) const {
+		for (; slot < Capacity; ++slot) {
+			if (cells[slot].active) return Position{ slot, nullptr };
+		}
+		return Position{};
+	}
+
+	std::array<Cell, Capacity> cells{};
+	ProbeScheme<SizePolicy> scheme;
+	size_t count = 0;
+};
+
+// Таблица по списку пар, емкость считается при компиляции по их числу:
+//   constexpr auto opcodes = make_constexpr_table<std::string_view, int>({ { "add", 1 }, { "sub", 2 } });
+//   static_assert(opcodes.value_or("sub", -1) == 2);
+template <typename K, typename V, typename SizePolicy = ModuloSizePolicy,
+	typename Hash = ConstexprHash<K>, typename KeyEqual = std::equal_to<K>, size_t N>
+consteval auto make_constexpr_table(const std::pair<K, V> (&items)[N]) {
+	return ConstexprHashTable<K, V, constexpr_table_capacity<SizePolicy>(N), SizePolicy, Hash, KeyEqual>(
+		std::span<const std::pair<K, V>>(items));
+}
@@ -0,0 +1,52 @@
+﻿#pragma once
+#include <cstddef>
+#include <memory>
+#include <algorithm>
+
+// Учет памяти, выделенной через CountingAllocator с одним и тем же Tag
+struct AllocationCounter {
+	size_t bytes = 0;       //выделено сейчас
+	size_t peak_bytes = 0;  //максимум bytes
+	size_t allocations = 0; //число вызовов allocate
+
+	void reset() { *this = AllocationCounter(); }
+};
+
+// Счетчик для Tag: общий для всех CountingAllocator<T, Tag> с любым T
+template <typename Tag>
+AllocationCounter& allocation_counter() {
+	static AllocationCounter counter;
+	return counter;
+}
+
+// Аллокатор без состояния поверх std::allocator, ведущий учет в allocation_counter<Tag>().
+// Разные Tag - раздельный учет (например, по одному на каждую измеряемую таблицу).
+// Счетчик не синхронизирован: выделять память из нескольких потоков нельзя
+template <typename T, typename Tag = void>
+class CountingAllocator {
+public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	CountingAllocator() noexcept = default;
+
+	template <typename U>
+	CountingAllocator(const CountingAllocator<U, Tag>&) noexcept {}
+
+	T* allocate(size_t n) {
+		T* p = std::allocator<T>().allocate(n);
+		AllocationCounter& counter = allocation_counter<Tag>();
+		counter.bytes += n * sizeof(T);
+		counter.peak_bytes = std::max(counter.peak_bytes, counter.bytes);
+		++counter.allocations;
+		return p;
+	}
+
+	void deallocate(T* p, size_t n) noexcept {
+		std::allocator<T>().deallocate(p, n);
+		allocation_counter<Tag>().bytes -= n * sizeof(T);
+	}
+
+	template <typename U>
+	bool operator==(const CountingAllocator<U, Tag>&) const noexcept { return true; }
+};
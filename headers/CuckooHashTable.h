@@ -0,0 +1,349 @@
+﻿#pragma once
+#include "IHashTable.h"
+#include "Hashers.h"
+#include <iostream>
+#include <vector>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+#include <bit>
+
+// Блочная кукушкина хеш-таблица: две хеш-функции, блоки по 4 ячейки.
+// Ключ может лежать только в одном из двух своих блоков, поэтому
+// find/contains просматривают не больше двух блоков (отпечатки + ключи),
+// значения хранятся отдельно и читаются только при попадании.
+// Вставка в заполненные блоки ищет путь вытеснений обходом в ширину
+// ограниченной глубины; если путь не найден - таблица рехэшируется
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+	requires KeyHasher<Hash, K> && KeyEquality<KeyEqual, K>
+class CuckooHashTable final : public IHashTable<K, V> {
+
+public:
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using typename IHashTable<K, V>::Position;
+
+	//----------- Конструкторы -------------------//
+	CuckooHashTable() = delete;
+
+	explicit CuckooHashTable(size_t size, double mlf = 0.9) : max_load_factor(mlf) {
+
+		if (size == 0) throw std::invalid_argument("Size must be positive");
+		if (mlf <= 0 || mlf >= 1) {
+			throw std::invalid_argument("Max load factor must be in (0, 1)");
+		}
+		allocate(bucket_count_for(size));
+	}
+
+	CuckooHashTable(const CuckooHashTable&) = default;
+
+	CuckooHashTable(CuckooHashTable&& other) noexcept
+		: buckets(std::move(other.buckets)),
+		values(std::move(other.values)),
+		bucket_mask(std::exchange(other.bucket_mask, 0)),
+		max_load_factor(other.max_load_factor),
+		element_count(std::exchange(other.element_count, 0))
+	{}
+
+	CuckooHashTable& operator=(const CuckooHashTable&) = default;
+
+	CuckooHashTable& operator=(CuckooHashTable&& other) noexcept {
+		if (this != &other) {
+			buckets = std::move(other.buckets);
+			values = std::move(other.values);
+			bucket_mask = std::exchange(other.bucket_mask, 0);
+			max_load_factor = other.max_load_factor;
+			element_count = std::exchange(other.element_count, 0);
+		}
+		return *this;
+	}
+	virtual ~CuckooHashTable() = default;
+
+	//---------- Основные операции-------------------//
+	//Операции вставки
+	bool insert(K key, const V& value) override {
+		if (find_index(key) != NPOS) return false;
+		place(std::move(key), V(value));
+		return true;
+	}
+
+	bool insert(K key, V&& value) override {
+		if (find_index(key) != NPOS) return false;
+		place(std::move(key), std::move(value));
+		return true;
+	}
+
+	//операции удаления
+	bool remove(const K& key) override {
+		size_t index = find_index(key);
+		if (index == NPOS) return false;
+
+		Bucket& bucket = buckets[index / SLOTS];
+		bucket.tags[index % SLOTS] = EMPTY_TAG;
+		bucket.keys[index % SLOTS] = K{};
+		values[index] = V{};
+		--element_count;
+		return true;
+	}
+
+	//операции доступа и поиска
+	bool contains(const K& key) const override {
+		return find_index(key) != NPOS;
+	}
+
+	V* find(const K& key) override {
+		size_t index = find_index(key);
+		return index == NPOS ? nullptr : &values[index];
+	}
+
+	const V* find(const K& key) const override {
+		size_t index = find_index(key);
+		return index == NPOS ? nullptr : &values[index];
+	}
+
+	V& at(const K& key) override {
+		size_t index = find_index(key);
+		if (index == NPOS) throw std::out_of_range("Key not found in hash table");
+		return values[index];
+	}
+
+	const V& at(const K& key) const override {
+		size_t index = find_index(key);
+		if (index == NPOS) throw std::out_of_range("Key not found in hash table");
+		return values[index];
+	}
+
+	// Только для неконстантных объектов
+	V& operator[](const K& key) override {
+		size_t index = find_index(key);
+		if (index != NPOS) return values[index];
+
+		return values[place(key, V{})];
+	}
+
+	//очистка
+	void clear() override {
+		allocate(bucket_mask + 1);
+	}
+
+	//---------- Рехэширование -------------------//
+	void rehash(size_t new_size) override {
+		if (new_size < element_count) {
+			throw std::invalid_argument("rehash: new size too small");
+		}
+		size_t new_buckets = bucket_count_for(new_size);
+		// Новая таблица должна вмещать все элементы с учетом max load factor
+		while (new_buckets * SLOTS * max_load_factor <= element_count) {
+			new_buckets *= 2;
+		}
+		if (new_buckets == bucket_mask + 1) return;
+
+		resize(new_buckets);
+	}
+
+	//---------- Характeристики-------------------//
+
+	//максимальное число ячеек (блоков * 4)
+	[[nodiscard]] size_t max_bucket_count() const noexcept override { return buckets.size() * SLOTS; }
+
+	//фактический размер
+	size_t size() const noexcept override { return element_count; }
+
+	//проверка на пустоту
+	bool empty() const noexcept override { return element_count == 0; }
+
+	// Коэффициент заполнения
+	double load_factor() const override {
+		return static_cast<double>(element_count) / (buckets.size() * SLOTS);
+	}
+
+	//максимальный коэффициент заполнения
+	double get_max_load_factor() const { return max_load_factor; }
+
+	//байт памяти таблицы; память, которой владеют ключи и значения, не учитывается
+	size_t memory_usage() const noexcept {
+		return sizeof(*this) + buckets.capacity() * sizeof(Bucket) + values.capacity() * sizeof(V);
+	}
+
+	//---------- Обход -------------------//
+	// Позиция - индекс ячейки: блок * 4 + ячейка в блоке
+	Position first_position() const override { return occupied_from(0); }
+
+	Position next_position(Position at) const override { return occupied_from(at.slot + 1); }
+
+	std::pair<const K*, const V*> entry_at(Position at) const override {
+		return { &buckets[at.slot / SLOTS].keys[at.slot % SLOTS], &values[at.slot] };
+	}
+
+private:
+	static constexpr size_t SLOTS = 4;              //ячеек в блоке
+	static constexpr size_t MAX_BFS_BUCKETS = 256;  //предел обхода при поиске пути вытеснений
+	static constexpr uint8_t EMPTY_TAG = 0;
+	static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+	struct Bucket { //отпечатки и ключи блока; значения - в отдельном массиве
+		uint8_t tags[SLOTS] = {}; //0 - ячейка пуста, иначе старшие биты хеша
+		K keys[SLOTS];
+	};
+
+	//перемешивание хеша (финализатор murmur3)
+	static uint64_t hash_of(const K& key) {
+		return murmur_mix(static_cast<uint64_t>(Hash{}(key)));
+	}
+	static uint8_t tag_of(uint64_t hash) { return static_cast<uint8_t>(hash >> 56) | 1; }
+
+	size_t first_bucket(uint64_t hash) const { return static_cast<size_t>(hash) & bucket_mask; }
+	//второй блок: xor с нечетным числом отличает его от первого и симметричен
+	size_t other_bucket(size_t bucket, uint64_t hash) const {
+		return (bucket ^ (static_cast<size_t>(hash >> 32) | 1)) & bucket_mask;
+	}
+
+	//первая занятая ячейка начиная с index
+	Position occupied_from(size_t index) const {
+		for (; index < buckets.size() * SLOTS; ++index) {
+			if (buckets[index / SLOTS].tags[index % SLOTS] != EMPTY_TAG) return { index };
+		}
+		return {};
+	}
+
+	//минимальное число блоков (степень двойки) под size ячеек
+	static size_t bucket_count_for(size_t size) {
+		return std::bit_ceil((size + SLOTS - 1) / SLOTS);
+	}
+
+	void allocate(size_t bucket_count) {
+		buckets = std::vector<Bucket>(bucket_count);
+		values = std::vector<V>(bucket_count * SLOTS);
+		bucket_mask = bucket_count - 1;
+		element_count = 0;
+	}
+
+	//поиск ключа в блоке; NPOS, если его там нет
+	size_t find_in_bucket(size_t b, uint8_t tag, const K& key) const {
+		const Bucket& bucket = buckets[b];
+		for (size_t s = 0; s < SLOTS; ++s) {
+			if (bucket.tags[s] == tag && KeyEqual{}(bucket.keys[s], key)) return b * SLOTS + s;
+		}
+		return NPOS;
+	}
+
+	//поиск индекса ячейки с ключом: не больше двух блоков
+	size_t find_index(const K& key) const {
+		uint64_t hash = hash_of(key);
+		uint8_t tag = tag_of(hash);
+		size_t b1 = first_bucket(hash);
+		size_t index = find_in_bucket(b1, tag, key);
+		if (index != NPOS) return index;
+		return find_in_bucket(other_bucket(b1, hash), tag, key);
+	}
+
+	//свободная ячейка блока; NPOS, если блок заполнен
+	size_t free_slot(size_t b) const {
+		for (size_t s = 0; s < SLOTS; ++s) {
+			if (buckets[b].tags[s] == EMPTY_TAG) return s;
+		}
+		return NPOS;
+	}
+
+	//перенос записи из ячейки (from_b, from_s) в свободную (to_b, to_s)
+	void move_slot(size_t from_b, size_t from_s, size_t to_b, size_t to_s) {
+		buckets[to_b].tags[to_s] = buckets[from_b].tags[from_s];
+		buckets[to_b].keys[to_s] = std::move(buckets[from_b].keys[from_s]);
+		values[to_b * SLOTS + to_s] = std::move(values[from_b * SLOTS + from_s]);
+		buckets[from_b].tags[from_s] = EMPTY_TAG;
+	}
+
+	//узел обхода в ширину: блок и ячейка родителя, запись из которой переедет сюда
+	struct PathNode {
+		size_t bucket;
+		size_t parent;
+		size_t parent_slot;
+	};
+
+	//освобождает ячейку в одном из двух блоков ключа; индекс ячейки или NPOS
+	size_t make_room(uint64_t hash) {
+		size_t b1 = first_bucket(hash);
+		size_t b2 = other_bucket(b1, hash);
+		if (size_t s = free_slot(b1); s != NPOS) return b1 * SLOTS + s;
+		if (size_t s = free_slot(b2); s != NPOS) return b2 * SLOTS + s;
+
+		std::vector<PathNode> queue{ { b1, NPOS, 0 }, { b2, NPOS, 0 } };
+		for (size_t head = 0; head < queue.size() && queue.size() < MAX_BFS_BUCKETS; ++head) {
+			for (size_t s = 0; s < SLOTS; ++s) {
+				size_t b = queue[head].bucket;
+				size_t alt = other_bucket(b, hash_of(buckets[b].keys[s]));
+				if (on_path(queue, head, alt)) continue;
+
+				size_t free = free_slot(alt);
+				if (free == NPOS) {
+					queue.push_back({ alt, head, s });
+					continue;
+				}
+				// путь найден: сдвигаем записи от конца пути к началу
+				move_slot(b, s, alt, free);
+				size_t node = head;
+				size_t freed = s;
+				while (queue[node].parent != NPOS) {
+					const PathNode& parent = queue[queue[node].parent];
+					move_slot(parent.bucket, queue[node].parent_slot, queue[node].bucket, freed);
+					freed = queue[node].parent_slot;
+					node = queue[node].parent;
+				}
+				return queue[node].bucket * SLOTS + freed;
+			}
+		}
+		return NPOS;
+	}
+
+	//блок уже есть среди предков узла - путь не должен проходить через блок дважды
+	static bool on_path(const std::vector<PathNode>& queue, size_t node, size_t bucket) {
+		for (; node != NPOS; node = queue[node].parent) {
+			if (queue[node].bucket == bucket) return true;
+		}
+		return false;
+	}
+
+	//размещение новой записи (ключа в таблице нет); возвращает индекс ячейки
+	template<typename KFwd>
+	size_t place(KFwd&& key, V&& value) {
+		if (element_count + 1 > buckets.size() * SLOTS * max_load_factor) {
+			resize(buckets.size() * 2);
+		}
+		uint64_t hash = hash_of(key);
+		size_t index = make_room(hash);
+		while (index == NPOS) { // вытеснения не помогли - рехэшируем
+			resize(buckets.size() * 2);
+			index = make_room(hash);
+		}
+
+		Bucket& bucket = buckets[index / SLOTS];
+		bucket.tags[index % SLOTS] = tag_of(hash);
+		bucket.keys[index % SLOTS] = std::forward<KFwd>(key);
+		values[index] = std::move(value);
+		++element_count;
+		return index;
+	}
+
+	//перенос всех записей в таблицу с new_buckets блоками
+	void resize(size_t new_buckets) {
+		std::vector<Bucket> old_buckets = std::move(buckets);
+		std::vector<V> old_values = std::move(values);
+
+		allocate(new_buckets);
+		for (size_t b = 0; b < old_buckets.size(); ++b) {
+			for (size_t s = 0; s < SLOTS; ++s) {
+				if (old_buckets[b].tags[s] == EMPTY_TAG) continue;
+				place(std::move(old_buckets[b].keys[s]), std::move(old_values[b * SLOTS + s]));
+			}
+		}
+	}
+
+private:
+	std::vector<Bucket> buckets; //отпечатки и ключи
+	std::vector<V> values;       //значения: ячейка s блока b - values[b * 4 + s]
+	size_t bucket_mask = 0;      //число блоков - 1
+
+	double max_load_factor;
+
+	size_t element_count = 0;    //количество элементов
+};
@@ -0,0 +1,191 @@
+﻿#pragma once
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include "BatchLookup.h"
+
+// Состояние ячейки таблицы с открытой адресацией
+enum class EntryState : uint8_t { EMPTY, ACTIVE, DELETED };
+
+// Расположение ячеек OpenHashTable в памяти (параметр шаблона Layout).
+// Layout::Storage<K, V, Allocator> - массив ячеек с доступом по номеру
+// к состоянию, ключу и значению. Для снимков (Snapshot.h) ячейки - это ARRAYS
+// массивов: for_each_image_piece отдает их как байты для записи, for_each_array -
+// для чтения, а View читает ячейки прямо из таких массивов в отображенном файле
+
+// Записи целиком: ключ, значение и состояние лежат подряд. Попадание читает
+// одну строку кэша, но каждая проба тянет в кэш и значение чужого ключа
+struct InterleavedLayout {
+	static constexpr uint32_t ID = 1; //для заголовка снимка
+
+	template <typename K, typename V, typename Allocator>
+	class Storage {
+		struct Entry;
+
+	public:
+		static constexpr size_t ARRAYS = 1;
+
+		Storage() = default;
+		explicit Storage(size_t size) : entries(size) {}
+
+		size_t size() const noexcept { return entries.size(); }
+
+		//байт в куче
+		size_t memory_usage() const noexcept { return entries.capacity() * sizeof(Entry); }
+
+		EntryState state(size_t i) const { return entries[i].state; }
+		void set_state(size_t i, EntryState s) { entries[i].state = s; }
+		bool is_active(size_t i) const { return entries[i].state == EntryState::ACTIVE; }
+		bool is_empty(size_t i) const { return entries[i].state == EntryState::EMPTY; }
+		bool is_deleted(size_t i) const { return entries[i].state == EntryState::DELETED; }
+
+		K& key(size_t i) { return entries[i].key; }
+		const K& key(size_t i) const { return entries[i].key; }
+		V& value(size_t i) { return entries[i].value; }
+		const V& value(size_t i) const { return entries[i].value; }
+
+		//предвыборка того, что читает проба
+		void prefetch(size_t i) const { prefetch_read(&entries[i]); }
+
+		//байт массива index у таблицы из size ячеек
+		static size_t array_bytes(size_t size, size_t) { return size * sizeof(Entry); }
+
+		//f(номер массива, указатель, байт) для образа: массив приходит кусками подряд.
+		//Записи копируются в обнуленный буфер, и образ зависит только от содержимого:
+		//байты выравнивания внутри Entry и ключи со значениями свободных ячеек - нули
+		template <typename F>
+		void for_each_image_piece(F&& f) const requires std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V> {
+			std::vector<Entry> buffer(std::min(IMAGE_CHUNK, entries.size()));
+			for (size_t first = 0; first < entries.size(); first += buffer.size()) {
+				size_t count = std::min(buffer.size(), entries.size() - first);
+				std::memset(static_cast<void*>(buffer.data()), 0, count * sizeof(Entry));
+				for (size_t i = 0; i != count; ++i) {
+					const Entry& entry = entries[first + i];
+					buffer[i].state = entry.state;
+					if (entry.state != EntryState::ACTIVE) continue;
+					buffer[i].key = entry.key;
+					buffer[i].value = entry.value;
+				}
+				f(size_t{ 0 }, static_cast<const void*>(buffer.data()), count * sizeof(Entry));
+			}
+		}
+
+		//f(указатель, байт) для каждого массива по порядку
+		template <typename F>
+		void for_each_array(F&& f) { f(static_cast<void*>(entries.data()), entries.size() * sizeof(Entry)); }
+
+		//ячейки только для чтения поверх массивов arrays[0 .. ARRAYS)
+		class View {
+		public:
+			View() = default;
+			explicit View(const std::byte* const* arrays) : entries(reinterpret_cast<const Entry*>(arrays[0])) {}
+
+			bool is_active(size_t i) const { return entries[i].state == EntryState::ACTIVE; }
+			bool is_empty(size_t i) const { return entries[i].state == EntryState::EMPTY; }
+			const K& key(size_t i) const { return entries[i].key; }
+			const V& value(size_t i) const { return entries[i].value; }
+
+		private:
+			const Entry* entries = nullptr;
+		};
+
+	private:
+		static constexpr size_t IMAGE_CHUNK = 1024; //записей в буфере for_each_image_piece
+
+		struct Entry {
+			K key;
+			V value;
+			EntryState state = EntryState::EMPTY;
+		};
+
+		std::vector<Entry, typename std::allocator_traits<Allocator>::template rebind_alloc<Entry>> entries;
+	};
+};
+
+// Раздельные массивы состояний, ключей и значений: пробинг читает только
+// плотные массивы состояний и ключей, значение загружается при попадании.
+// Выгодно при больших значениях, частых промахах и высоком заполнении
+struct SplitLayout {
+	static constexpr uint32_t ID = 2;
+
+	template <typename K, typename V, typename Allocator>
+	class Storage {
+	public:
+		static constexpr size_t ARRAYS = 3;
+
+		Storage() = default;
+		explicit Storage(size_t size) : states(size, EntryState::EMPTY), keys(size), values(size) {}
+
+		size_t size() const noexcept { return states.size(); }
+
+		//байт в куче
+		size_t memory_usage() const noexcept {
+			return states.capacity() * sizeof(EntryState) + keys.capacity() * sizeof(K) + values.capacity() * sizeof(V);
+		}
+
+		EntryState state(size_t i) const { return states[i]; }
+		void set_state(size_t i, EntryState s) { states[i] = s; }
+		bool is_active(size_t i) const { return states[i] == EntryState::ACTIVE; }
+		bool is_empty(size_t i) const { return states[i] == EntryState::EMPTY; }
+		bool is_deleted(size_t i) const { return states[i] == EntryState::DELETED; }
+
+		K& key(size_t i) { return keys[i]; }
+		const K& key(size_t i) const { return keys[i]; }
+		V& value(size_t i) { return values[i]; }
+		const V& value(size_t i) const { return values[i]; }
+
+		//предвыборка того, что читает проба: состояние и ключ
+		void prefetch(size_t i) const {
+			prefetch_read(&states[i]);
+			prefetch_read(&keys[i]);
+		}
+
+		static size_t array_bytes(size_t size, size_t index) {
+			return size * (index == 0 ? sizeof(EntryState) : index == 1 ? sizeof(K) : sizeof(V));
+		}
+
+		template <typename F>
+		void for_each_image_piece(F&& f) const {
+			f(size_t{ 0 }, static_cast<const void*>(states.data()), states.size() * sizeof(EntryState));
+			f(size_t{ 1 }, static_cast<const void*>(keys.data()), keys.size() * sizeof(K));
+			f(size_t{ 2 }, static_cast<const void*>(values.data()), values.size() * sizeof(V));
+		}
+		template <typename F>
+		void for_each_array(F&& f) {
+			f(static_cast<void*>(states.data()), states.size() * sizeof(EntryState));
+			f(static_cast<void*>(keys.data()), keys.size() * sizeof(K));
+			f(static_cast<void*>(values.data()), values.size() * sizeof(V));
+		}
+
+		class View {
+		public:
+			View() = default;
+			explicit View(const std::byte* const* arrays)
+				: states(reinterpret_cast<const EntryState*>(arrays[0])),
+				keys(reinterpret_cast<const K*>(arrays[1])),
+				values(reinterpret_cast<const V*>(arrays[2])) {}
+
+			bool is_active(size_t i) const { return states[i] == EntryState::ACTIVE; }
+			bool is_empty(size_t i) const { return states[i] == EntryState::EMPTY; }
+			const K& key(size_t i) const { return keys[i]; }
+			const V& value(size_t i) const { return values[i]; }
+
+		private:
+			const EntryState* states = nullptr;
+			const K* keys = nullptr;
+			const V* values = nullptr;
+		};
+
+	private:
+		template <typename T>
+		using Array = std::vector<T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>;
+
+		Array<EntryState> states;
+		Array<K> keys;
+		Array<V> values;
+	};
+};
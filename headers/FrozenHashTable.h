@@ -0,0 +1,254 @@
+﻿#pragma once
+#include "IHashTable.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <bit>
+#include "Hashers.h"
+
+// Неизменяемая таблица с минимальным совершенным хешированием (в духе PTHash):
+// n ключей лежат ровно в n ячейках, без пустых мест. Ключи разбиты на бакеты по хешу,
+// для каждого бакета при построении подобран номер-пилот, при котором ячейки всех его
+// ключей свободны и различны. Поиск - хеш, пилот бакета, одна ячейка и одно сравнение.
+// Строится из готовой таблицы через freeze() у ChainHashTable и OpenHashTable или из
+// вектора пар с различными ключами. Ключи с одинаковым полным хешем пилот не
+// разделяет: все, кроме первого, лежат в хвосте массива и просматриваются при промахе
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+	requires KeyHasher<Hash, K> && KeyEquality<KeyEqual, K>
+class FrozenHashTable {
+
+	struct Entry;
+
+public:
+	using key_type = K;
+	using mapped_type = V;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using Position = TablePosition;
+
+	//----------- Конструкторы -------------------//
+	FrozenHashTable() = default;
+
+	// Ключи должны быть различны, иначе std::invalid_argument
+	explicit FrozenHashTable(std::vector<std::pair<K, V>> items) { build(items); }
+
+	//---------- Поиск -------------------//
+	bool contains(const K& key) const { return find(key) != nullptr; }
+	const V* find(const K& key) const { return lookup(key); }
+
+	const V& at(const K& key) const {
+		const V* value = find(key);
+		if (!value) throw std::out_of_range("Key not found in hash table");
+		return *value;
+	}
+
+	// Поиск по ключу другого типа с прозрачными Hash и KeyEqual
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	bool contains(const Q& key) const { return find(key) != nullptr; }
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	const V* find(const Q& key) const { return lookup(key); }
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	const V& at(const Q& key) const {
+		const V* value = find(key);
+		if (!value) throw std::out_of_range("Key not found in hash table");
+		return *value;
+	}
+
+	//---------- Характеристики -------------------//
+	size_t size() const noexcept { return entries.size(); }
+	bool empty() const noexcept { return entries.empty(); }
+
+	//ячеек, адресуемых хешем
+	size_t max_bucket_count() const noexcept { return slots; }
+
+	//пустых ячеек нет
+	double load_factor() const { return slots ? 1.0 : 0.0; }
+
+	//бакетов с пилотами
+	size_t pilot_count() const noexcept { return pilots.size(); }
+
+	//ключей с повторяющимся полным хешем (просматриваются при промахе)
+	size_t overflow_count() const noexcept { return entries.size() - slots; }
+
+	//байт памяти: объект, ячейки и пилоты (без памяти, которой владеют ключи и значения)
+	size_t memory_usage() const noexcept {
+		return sizeof(*this) + entries.capacity() * sizeof(Entry) + pilots.capacity() * sizeof(uint32_t);
+	}
+
+	//---------- Обход -------------------//
+	Position first_position() const { return entries.empty() ? Position{} : Position{ 0, nullptr }; }
+
+	Position next_position(Position at) const {
+		return at.slot + 1 < entries.size() ? Position{ at.slot + 1, nullptr } : Position{};
+	}
+
+	std::pair<const K*, const V*> entry_at(Position at) const {
+		const Entry& entry = entries[at.slot];
+		return { &entry.key, &entry.value };
+	}
+
+private:
+	static constexpr double BUCKET_DENSITY = 6.0;         //бакетов: BUCKET_DENSITY * n / log2(n)
+	static constexpr uint32_t DENSE_KEYS = 0x99999999u;   //60% ключей (по младшим 32 битам хеша)...
+	static constexpr double DENSE_BUCKETS = 0.3;          //...попадают в 30% бакетов: большие бакеты строятся первыми
+	static constexpr uint32_t MAX_PILOT = 1u << 30;       //дальше - построение с другой затравкой
+	static constexpr size_t MAX_ATTEMPTS = 8;
+
+	struct Entry {
+		K key;
+		V value;
+	};
+
+	template <typename Q>
+	const V* lookup(const Q& key) const {
+		if (slots == 0) return nullptr;
+		uint64_t h = key_hash(key);
+		const Entry& entry = entries[position(h, pilots[bucket(h)])];
+		if (KeyEqual{}(entry.key, key)) return &entry.value;
+		for (size_t i = slots; i < entries.size(); ++i) { // обычно хвост пуст
+			if (KeyEqual{}(entries[i].key, key)) return &entries[i].value;
+		}
+		return nullptr;
+	}
+
+	template <typename Q>
+	uint64_t key_hash(const Q& key) const {
+		return murmur_mix(static_cast<uint64_t>(Hash{}(key)) ^ seed);
+	}
+
+	size_t bucket(uint64_t h) const {
+		return static_cast<uint32_t>(h) < DENSE_KEYS
+			? static_cast<size_t>(mul_high_u64(h, dense))
+			: dense + static_cast<size_t>(mul_high_u64(h, pilots.size() - dense));
+	}
+
+	size_t position(uint64_t h, uint32_t pilot) const {
+		return static_cast<size_t>(mul_high_u64(murmur_mix(h ^ (pilot * WY_P0)), slots));
+	}
+
+	void build(std::vector<std::pair<K, V>>& items) {
+		const size_t n = items.size();
+		if (n == 0) return;
+
+		std::vector<uint64_t> hashes(n);
+		for (size_t i = 0; i != n; ++i) {
+			hashes[i] = static_cast<uint64_t>(Hash{}(items[i].first));
+		}
+		size_t log_n = std::max<size_t>(std::bit_width(n) - 1, 1);
+		// не меньше двух бакетов: тогда dense < bucket_count и у редких ключей есть свои бакеты
+		size_t bucket_count = std::clamp<size_t>(static_cast<size_t>(BUCKET_DENSITY * n / log_n), 2, std::max<size_t>(n, 2));
+
+		std::vector<size_t> at; //номер элемента для каждой ячейки, затем хвост
+		for (size_t attempt = 0; attempt != MAX_ATTEMPTS; ++attempt) {
+			seed = murmur_mix(attempt + 1);
+			pilots.assign(bucket_count, 0);
+			dense = std::max<size_t>(static_cast<size_t>(DENSE_BUCKETS * bucket_count), 1);
+			if (try_build(items, hashes, at)) break;
+			at.clear();
+		}
+		if (at.empty()) throw std::runtime_error("Frozen: cannot build perfect hash");
+
+		entries.reserve(n);
+		for (size_t i : at) {
+			entries.push_back(Entry{ std::move(items[i].first), std::move(items[i].second) });
+		}
+	}
+
+	// Подбор пилотов при текущей затравке: false, если пилот бакета не нашелся
+	bool try_build(const std::vector<std::pair<K, V>>& items, const std::vector<uint64_t>& hashes,
+		std::vector<size_t>& at) {
+		const size_t n = items.size();
+		const size_t buckets = pilots.size();
+		std::vector<uint64_t> h(n);
+		for (size_t i = 0; i != n; ++i) {
+			h[i] = murmur_mix(hashes[i] ^ seed);
+		}
+
+		// элементы по бакетам: members[offsets[b] .. offsets[b + 1])
+		std::vector<size_t> offsets(buckets + 1, 0);
+		std::vector<size_t> home(n);
+		for (size_t i = 0; i != n; ++i) {
+			home[i] = bucket(h[i]);
+			++offsets[home[i] + 1];
+		}
+		for (size_t b = 0; b != buckets; ++b) offsets[b + 1] += offsets[b];
+		std::vector<size_t> members(n);
+		{
+			std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i != n; ++i) members[next[home[i]]++] = i;
+		}
+
+		// одинаковый полный хеш - в хвост; одинаковые ключи - ошибка
+		std::vector<size_t> overflow;
+		std::vector<size_t> sizes(buckets);
+		size_t max_size = 0;
+		for (size_t b = 0; b != buckets; ++b) {
+			auto first = members.begin() + offsets[b];
+			auto last = members.begin() + offsets[b + 1];
+			std::sort(first, last, [&](size_t x, size_t y) { return h[x] < h[y]; });
+			auto kept = first;
+			for (auto run = first; run != last;) { // run - элементы с одинаковым хешем
+				auto end = std::find_if(run, last, [&](size_t i) { return h[i] != h[*run]; });
+				for (auto x = run; x != end; ++x) {
+					for (auto y = x + 1; y != end; ++y) {
+						if (KeyEqual{}(items[*x].first, items[*y].first)) {
+							throw std::invalid_argument("Frozen: duplicate key");
+						}
+					}
+				}
+				*kept++ = *run;
+				overflow.insert(overflow.end(), run + 1, end);
+				run = end;
+			}
+			sizes[b] = static_cast<size_t>(kept - first);
+			max_size = std::max(max_size, sizes[b]);
+		}
+		slots = n - overflow.size();
+
+		// бакеты по убыванию размера (сортировка подсчетом)
+		std::vector<size_t> by_size(max_size + 2, 0);
+		for (size_t b = 0; b != buckets; ++b) ++by_size[max_size - sizes[b] + 1];
+		for (size_t s = 0; s <= max_size; ++s) by_size[s + 1] += by_size[s];
+		std::vector<size_t> order(buckets);
+		for (size_t b = 0; b != buckets; ++b) order[by_size[max_size - sizes[b]]++] = b;
+
+		at.assign(n, 0);
+		std::vector<uint64_t> taken((slots + 63) / 64, 0);
+		auto is_taken = [&](size_t pos) { return (taken[pos / 64] >> (pos % 64)) & 1; };
+		auto flip = [&](size_t pos) { taken[pos / 64] ^= uint64_t{ 1 } << (pos % 64); };
+		std::vector<size_t> placed;
+		for (size_t b : order) {
+			if (sizes[b] == 0) break;
+			const size_t* first = members.data() + offsets[b];
+			uint32_t pilot = 0;
+			for (;; ++pilot) {
+				if (pilot == MAX_PILOT) return false;
+				placed.clear();
+				for (size_t j = 0; j != sizes[b]; ++j) {
+					size_t pos = position(h[first[j]], pilot);
+					if (is_taken(pos)) break;
+					flip(pos); // занята и своим же бакетом - для проверки различия
+					placed.push_back(pos);
+				}
+				if (placed.size() == sizes[b]) break;
+				for (size_t pos : placed) flip(pos);
+			}
+			pilots[b] = pilot;
+			for (size_t j = 0; j != sizes[b]; ++j) at[placed[j]] = first[j];
+		}
+		std::copy(overflow.begin(), overflow.end(), at.begin() + slots);
+		return true;
+	}
+
+	std::vector<Entry> entries;   //ячейки [0, slots), затем ключи с повторяющимся хешем
+	std::vector<uint32_t> pilots; //пилот каждого бакета
+	size_t slots = 0;             //ячеек, адресуемых хешем
+	size_t dense = 0;             //бакетов для 60% ключей
+	uint64_t seed = 0;            //затравка хеша, при которой нашлись все пилоты
+};
@@ -0,0 +1,123 @@
+﻿#pragma once
+#include "IHashTable.h"
+#include <concepts>
+#include <utility>
+
+// Статический интерфейс хеш-таблицы: те же операции, что в IHashTable, но
+// проверяются при компиляции. Шаблон, принимающий HashTableLike, вызывает методы
+// конкретного класса напрямую - без таблицы виртуальных функций, и компилятор
+// может их встроить. Все таблицы проекта объявлены final, поэтому вызов через
+// конкретный тип не виртуальный даже при наследовании от IHashTable
+
+// Читающая половина интерфейса: поиск, характеристики и обход. Ей удовлетворяют
+// и неизменяемые таблицы (FrozenHashTable)
+template<typename T>
+concept ReadOnlyHashTableLike = requires {
+	typename T::key_type;
+	typename T::mapped_type;
+} && requires(const T& ctable, const typename T::key_type& key, TablePosition at) {
+	//доступ и поиск
+	{ ctable.contains(key) } -> std::same_as<bool>;
+	{ ctable.find(key) } -> std::same_as<const typename T::mapped_type*>;
+	{ ctable.at(key) } -> std::same_as<const typename T::mapped_type&>;
+
+	//характеристики
+	{ ctable.size() } -> std::convertible_to<size_t>;
+	{ ctable.empty() } -> std::convertible_to<bool>;
+	{ ctable.load_factor() } -> std::convertible_to<double>;
+	{ ctable.max_bucket_count() } -> std::convertible_to<size_t>;
+
+	//обход
+	{ ctable.first_position() } -> std::same_as<TablePosition>;
+	{ ctable.next_position(at) } -> std::same_as<TablePosition>;
+	{ ctable.entry_at(at) } -> std::same_as<std::pair<const typename T::key_type*, const typename T::mapped_type*>>;
+};
+
+template<typename T>
+concept HashTableLike = ReadOnlyHashTableLike<T>
+	&& requires(T& table, const typename T::key_type& key,
+	typename T::key_type k, typename T::mapped_type v, const typename T::mapped_type& cv, size_t n) {
+	//вставка и удаление
+	{ table.insert(k, cv) } -> std::same_as<bool>;
+	{ table.insert(k, std::move(v)) } -> std::same_as<bool>;
+	{ table.remove(key) } -> std::same_as<bool>;
+
+	//доступ и поиск в изменяемой таблице
+	{ table.find(key) } -> std::same_as<typename T::mapped_type*>;
+	{ table.at(key) } -> std::same_as<typename T::mapped_type&>;
+	{ table[key] } -> std::same_as<typename T::mapped_type&>;
+
+	//очистка и рехэширование
+	table.clear();
+	table.rehash(n);
+};
+
+// Адаптер к виртуальному интерфейсу для любой HashTableLike-таблицы:
+// нужен, когда тип таблицы выбирается во время выполнения или хранится
+// за ссылкой на IHashTable. Таблица лежит внутри адаптера, get() дает
+// к ней прямой доступ без виртуальных вызовов
+template <HashTableLike Table>
+class HashTableAdapter final : public IHashTable<typename Table::key_type, typename Table::mapped_type> {
+
+	using K = typename Table::key_type;
+	using V = typename Table::mapped_type;
+	using typename IHashTable<K, V>::Position;
+
+public:
+	//----------- Конструкторы -------------------//
+	HashTableAdapter() = delete;
+
+	// Аргументы передаются конструктору таблицы
+	template <typename... Args>
+		requires std::constructible_from<Table, Args...>
+	explicit HashTableAdapter(Args&&... args) : table(std::forward<Args>(args)...) {}
+
+	HashTableAdapter(const HashTableAdapter&) = default;
+	HashTableAdapter(HashTableAdapter&&) noexcept = default;
+	HashTableAdapter& operator=(const HashTableAdapter&) = default;
+	HashTableAdapter& operator=(HashTableAdapter&&) noexcept = default;
+	virtual ~HashTableAdapter() = default;
+
+	//---------- Доступ к таблице -------------------//
+	Table& get() noexcept { return table; }
+	const Table& get() const noexcept { return table; }
+
+	//---------- Основные операции-------------------//
+	bool insert(K key, const V& value) override { return table.insert(std::move(key), value); }
+	bool insert(K key, V&& value) override { return table.insert(std::move(key), std::move(value)); }
+
+	bool remove(const K& key) override { return table.remove(key); }
+
+	bool contains(const K& key) const override { return table.contains(key); }
+
+	V* find(const K& key) override { return table.find(key); }
+	const V* find(const K& key) const override { return table.find(key); }
+
+	V& at(const K& key) override { return table.at(key); }
+	const V& at(const K& key) const override { return table.at(key); }
+
+	V& operator[](const K& key) override { return table[key]; }
+
+	void clear() override { table.clear(); }
+
+	//---------- Рехэширование -------------------//
+	void rehash(size_t new_size) override { table.rehash(new_size); }
+
+	//---------- Характeристики-------------------//
+	[[nodiscard]] size_t max_bucket_count() const noexcept override { return table.max_bucket_count(); }
+	size_t size() const noexcept override { return table.size(); }
+	bool empty() const noexcept override { return table.empty(); }
+	double load_factor() const override { return table.load_factor(); }
+
+	double get_max_load_factor() const requires requires(const Table& t) { t.get_max_load_factor(); } {
+		return table.get_max_load_factor();
+	}
+
+	//---------- Обход -------------------//
+	Position first_position() const override { return table.first_position(); }
+	Position next_position(Position at) const override { return table.next_position(at); }
+	std::pair<const K*, const V*> entry_at(Position at) const override { return table.entry_at(at); }
+
+private:
+	Table table;
+};
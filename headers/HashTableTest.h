@@ -9,8 +9,27 @@
 #include <set>
 #include <functional>
 #include <concepts>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <array>
+#include <utility>
+#include <string_view>
+#include <type_traits>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
 #include "ChainHashTable.h"
 #include "OpenHashTable.h"
+#include "MappedSnapshot.h"
+#include "ConcurrentShardedHashTable.h"
+#include "Hashers.h"
+#include "HashTableLike.h"
+#include "CountingAllocator.h"
+#include "ConstexprHashTable.h"
 
 using IntStringTable = IHashTable<int, std::string>;
 
@@ -41,6 +60,87 @@ public:
         if constexpr (std::is_same_v<HashTable, OpenHashTable<int, std::string>>) {
             test_coefficients();
         }
+
+        // 6. Тест инкрементального рехэширования
+        if constexpr (std::is_same_v<HashTable, OpenHashTable<int, std::string>>) {
+            test_incremental_rehash();
+        }
+
+        // 7. Тест надгробий и уплотнения
+        if constexpr (std::is_same_v<HashTable, OpenHashTable<int, std::string>>) {
+            test_tombstones();
+        }
+
+        // 8. Тест конкурентного доступа
+        if constexpr (requires(const HashTable& t) { t.get(0); }) {
+            test_concurrency();
+        }
+
+        // 9. Тест пакетных операций
+        test_batch();
+
+        // 10. Сравнение хеш-функций
+        if constexpr (std::is_same_v<HashTable, OpenHashTable<int, std::string>>) {
+            test_hashers();
+        }
+
+        // 11. Тест поиска по ключу другого типа
+        if constexpr (std::is_same_v<HashTable, ChainHashTable<int, std::string>>
+            || std::is_same_v<HashTable, OpenHashTable<int, std::string>>) {
+            test_transparent_lookup();
+        }
+
+        // 12. Тест вставки на месте и замены значений
+        test_emplace();
+
+        // 13. Тест обхода
+        test_iteration();
+
+        // 14. Статический и виртуальный интерфейс
+        test_static_interface();
+
+        // 15. Статистика таблицы
+        if constexpr (std::is_same_v<HashTable, ChainHashTable<int, std::string>>) {
+            test_stats<ChainHashTable<int, std::string, ModuloSizePolicy, std::hash<int>, std::equal_to<int>, CountingStats>>();
+        }
+        if constexpr (std::is_same_v<HashTable, OpenHashTable<int, std::string>>) {
+            test_stats<OpenHashTable<int, std::string, ModuloSizePolicy, std::hash<int>, std::equal_to<int>, CountingStats>>();
+        }
+
+        // 16. Расход памяти
+        if constexpr (requires(const HashTable& t) { t.memory_usage(); }) {
+            test_memory();
+        }
+
+        // 17. Расположение ячеек OpenHashTable
+        if constexpr (std::is_same_v<HashTable, OpenHashTable<int, std::string>>) {
+            test_layout();
+        }
+
+        // 18. Параллельная загрузка
+        if constexpr (requires(HashTable& t, std::span<const std::pair<int, std::string>> items) { t.insert_bulk(items, 1); }) {
+            test_bulk_load();
+        }
+
+        // 19. Параллельное рехэширование
+        if constexpr (requires(HashTable& t) { t.rehash(size_t{ 1 }, size_t{ 1 }); }) {
+            test_parallel_rehash();
+        }
+
+        // 20. Снимки OpenHashTable
+        if constexpr (std::is_same_v<HashTable, OpenHashTable<int, std::string>>) {
+            test_snapshot();
+        }
+
+        // 21. Заморозка в FrozenHashTable
+        if constexpr (requires(const HashTable& t) { t.freeze(); }) {
+            test_freeze();
+        }
+
+        // 22. Таблица, построенная при компиляции
+        if constexpr (std::is_same_v<HashTable, OpenHashTable<int, std::string>>) {
+            test_constexpr_table();
+        }
         std::cout << "\n========================================\n";
         std::cout << "ALL TESTS PASSED SUCCESSFULLY!\n";
         std::cout << "========================================\n";
@@ -96,6 +196,35 @@ private:
 		assert(hashtable.size() == 0);
 		std::cout << "+ Clear operation passed\n";
 
+		// 1.7 Автоматический рост при достижении max load factor
+		for (int i = 0; i != 100; ++i) {
+			hashtable.insert(i, std::to_string(i));
+		}
+		assert(hashtable.size() == 100);
+		assert(hashtable.max_bucket_count() > M);
+		assert(hashtable.load_factor() <= hashtable.get_max_load_factor());
+		for (int i = 0; i != 100; ++i) {
+			assert(hashtable.contains(i));
+		}
+		std::cout << "+ Automatic growth passed\n";
+
+		// 1.8 Рост при max load factor больше коэффициента роста: одного умножения
+		// числа бакетов не хватает, вставка не должна падать на проверке rehash
+		if constexpr (std::is_same_v<HashTable, ChainHashTable<int, std::string>>) {
+			HashTable dense(10, 3.0, 2.0);
+			for (int i = 0; i != 5000; ++i) {
+				bool success = dense.insert(i, std::to_string(i));
+				assert(success);
+			}
+			assert(dense.size() == 5000);
+			assert(dense.load_factor() <= 3.0);
+			for (int i = 0; i != 5000; ++i) {
+				assert(dense.contains(i));
+			}
+			std::cout << "+ Growth with max load factor above growth factor passed, buckets "
+				<< dense.max_bucket_count() << "\n";
+		}
+
 		std::cout << "++ All edge cases passed\n\n";
 	}
 
@@ -155,6 +284,30 @@ private:
 		self_assigned = self_assigned; // self-assignment
 		verify_equality(original, self_assigned, data, "self assigment");
 		std::cout << "+ Self-assignment\n";
+
+		// 4.6 Присваивание между таблицами разного размера, затем вставка и поиск
+		HashTable small(7), large(1000);
+		for (int i = 0; i != 3; ++i) small.insert(-1 - i, "small");
+		for (int i = 0; i != 600; ++i) large.insert(i, std::to_string(i));
+		HashTable assigned(7);
+		assigned = large;           // копирование в меньшую
+		HashTable moved(1000);
+		moved = std::move(small);   // перемещение в большую
+		large = assigned;           // копирование в равную по размеру не ломает прежнее
+		for (int i = 600; i != 2000; ++i) {
+			bool success = assigned.insert(i, std::to_string(i));
+			assert(success);
+			success = moved.insert(i, std::to_string(i));
+			assert(success);
+		}
+		for (int i = 0; i != 2000; ++i) {
+			const std::string* value = assigned.find(i);
+			assert(value && *value == std::to_string(i));
+			assert(moved.contains(i) == (i >= 600));
+		}
+		assert(moved.size() == 1403 && moved.contains(-3) && !moved.contains(-4));
+		assert(large.size() == 600 && large.contains(599));
+		std::cout << "+ Assignment between tables of different sizes\n";
 		std::cout << "++ Copy/move semantics test completed\n\n";
 	}	    
     
@@ -174,6 +327,15 @@ private:
 			single_main_test(M, A, B);
         }
 
+		// Автоматический рост всегда попадает на размер, взаимно простой с A и B
+		OpenHashTable<int, std::string> growing(11, 2, 3);
+		for (int i = 0; i != 10000; ++i) {
+			bool success = growing.insert(i, std::to_string(i));
+			assert(success);
+		}
+		assert(growing.size() == 10000);
+		std::cout << "+ Growth with A = 2, B = 3 passed, buckets " << growing.max_bucket_count() << "\n";
+
 		std::cout << "++ Coefficients test completed\n\n";
     }
 	
@@ -219,6 +381,1120 @@ private:
 			}
 		}
 	}    
+	// Тест инкрементального рехэширования (для OpenHashTable)
+	static void test_incremental_rehash() {
+		std::cout << "\n6. INCREMENTAL REHASH TEST\n";
+		std::cout << "------------------\n";
+
+		// 6.1 Корректность операций во время переноса
+		const int N = 100000;
+		OpenHashTable<int, std::string> table(11, 0, 1, 0.75, RehashMode::INCREMENTAL);
+		bool seen_migration = false;
+		for (int i = 0; i != N; ++i) {
+			bool success = table.insert(i, std::to_string(i));
+			assert(success);
+			if (table.migrating()) {
+				seen_migration = true;
+				success = table.insert(i / 2, std::string("dup")); // ключ может быть в старой таблице
+				assert(!success);
+			}
+		}
+		assert(seen_migration);
+		assert(table.size() == static_cast<size_t>(N));
+		for (int i = 0; i != N; ++i) {
+			assert(table.contains(i));
+			assert(*table.find(i) == std::to_string(i));
+		}
+		for (int i = 0; i < N; i += 2) {
+			bool success = table.remove(i);
+			assert(success);
+		}
+		assert(table.size() == static_cast<size_t>(N / 2));
+		for (int i = 0; i != N; ++i) {
+			assert(table.contains(i) == (i % 2 == 1));
+		}
+		table.finish_migration();
+		assert(!table.migrating());
+		assert(table.size() == static_cast<size_t>(N / 2));
+		std::cout << "+ Operations during migration passed\n";
+
+		std::cout << "++ Incremental rehash test completed\n\n";
+	}
+
+	// Тест надгробий и уплотнения (для OpenHashTable)
+	static void test_tombstones() {
+		std::cout << "\n7. TOMBSTONES TEST\n";
+		std::cout << "------------------\n";
+
+		// 7.1 Явное уплотнение
+		OpenHashTable<int, std::string> table(1009);
+		for (int i = 0; i != 700; ++i) {
+			table.insert(i, std::to_string(i));
+		}
+		for (int i = 0; i < 700; i += 3) {
+			table.remove(i);
+		}
+		assert(table.tombstone_count() > 0);
+		table.compact();
+		assert(table.tombstone_count() == 0);
+		assert(table.max_bucket_count() == 1009);
+		for (int i = 0; i != 700; ++i) {
+			assert(table.contains(i) == (i % 3 != 0));
+			assert(i % 3 == 0 || *table.find(i) == std::to_string(i));
+		}
+		std::cout << "+ Explicit compaction passed\n";
+
+		// 7.2 Постоянные вставки/удаления: надгробия не копятся, таблица не растет
+		OpenHashTable<int, std::string> churn(1009);
+		std::mt19937 g(42);
+		std::uniform_int_distribution<int> dist(0, 1 << 30);
+		std::vector<int> live;
+		size_t max_tombstones = 0;
+		for (int i = 0; i != 200000; ++i) {
+			int key = dist(g);
+			if (churn.insert(key, std::to_string(key))) live.push_back(key);
+			if (live.size() > 300) {
+				size_t victim = g() % live.size();
+				bool success = churn.remove(live[victim]);
+				assert(success);
+				live[victim] = live.back();
+				live.pop_back();
+			}
+			max_tombstones = std::max(max_tombstones, churn.tombstone_count());
+		}
+		assert(churn.size() == live.size());
+		assert(churn.max_bucket_count() == 1009);
+		for (int key : live) {
+			assert(churn.contains(key));
+		}
+		std::cout << "+ Churn passed: buckets " << churn.max_bucket_count()
+			<< ", max tombstones " << max_tombstones << "\n";
+		std::cout << "++ Tombstones test completed\n\n";
+	}
+
+	// Тест конкурентного доступа (для потокобезопасных таблиц)
+	static void test_concurrency() {
+		std::cout << "\n8. CONCURRENCY TEST\n";
+		std::cout << "------------------\n";
+
+		const int THREADS = 8;
+		const int PER_THREAD = 50000;
+
+		// 8.1 Параллельные вставки непересекающихся ключей вместе с чтением
+		HashTable table(1024);
+		std::atomic<bool> readers_done{ false };
+		std::vector<std::thread> threads;
+		for (int t = 0; t != THREADS; ++t) {
+			threads.emplace_back([&table, t]() {
+				for (int i = t * PER_THREAD; i != (t + 1) * PER_THREAD; ++i) {
+					bool success = table.insert(i, std::to_string(i));
+					assert(success);
+				}
+			});
+		}
+		std::thread reader([&table, &readers_done]() {
+			// найденное значение всегда целое: get копирует его под блокировкой шарда
+			while (!readers_done) {
+				for (int i = 0; i < THREADS * PER_THREAD; i += 997) {
+					auto value = table.get(i);
+					assert(!value || *value == std::to_string(i));
+				}
+			}
+		});
+		for (auto& thread : threads) thread.join();
+		readers_done = true;
+		reader.join();
+		threads.clear();
+
+		assert(table.size() == static_cast<size_t>(THREADS * PER_THREAD));
+		for (int i = 0; i != THREADS * PER_THREAD; ++i) {
+			assert(table.contains(i));
+		}
+		std::cout << "+ Parallel inserts passed, buckets " << table.max_bucket_count() << "\n";
+
+		// 8.2 Параллельные удаления и обновления через visit (если таблица его поддерживает)
+		constexpr bool HAS_VISIT = requires(HashTable& t) { t.visit(0, [](std::string&) {}); };
+		for (int t = 0; t != THREADS; ++t) {
+			threads.emplace_back([&table, t]() {
+				for (int i = t * PER_THREAD; i != (t + 1) * PER_THREAD; ++i) {
+					if (i % 2 == 0) {
+						bool success = table.remove(i);
+						assert(success);
+					}
+					else if constexpr (HAS_VISIT) {
+						bool success = table.visit(i, [](std::string& value) { value += "!"; });
+						assert(success);
+					}
+				}
+			});
+		}
+		for (auto& thread : threads) thread.join();
+		threads.clear();
+
+		assert(table.size() == static_cast<size_t>(THREADS * PER_THREAD / 2));
+		for (int i = 0; i != THREADS * PER_THREAD; ++i) {
+			assert(table.contains(i) == (i % 2 == 1));
+			assert(i % 2 == 0 || *table.get(i) == std::to_string(i) + (HAS_VISIT ? "!" : ""));
+		}
+		std::cout << "+ Parallel removes and updates passed\n";
+
+		// 8.3 Вставки и удаления в маленькой таблице: частые перестроения того же
+		// размера (из-за надгробий) во время конкурентных вставок
+		const int WINDOW = 8;
+		const int CHURN = 20000;
+		HashTable churn(16);
+		for (int t = 0; t != THREADS; ++t) {
+			threads.emplace_back([&churn, t]() {
+				for (int i = 0; i != CHURN; ++i) {
+					bool success = churn.insert(t * CHURN + i, std::to_string(i));
+					assert(success);
+					if (i >= WINDOW) {
+						success = churn.remove(t * CHURN + i - WINDOW);
+						assert(success);
+					}
+				}
+			});
+		}
+		for (auto& thread : threads) thread.join();
+		threads.clear();
+
+		assert(churn.size() == static_cast<size_t>(THREADS * WINDOW));
+		for (int t = 0; t != THREADS; ++t) {
+			for (int i = 0; i != CHURN; ++i) {
+				assert(churn.contains(t * CHURN + i) == (i >= CHURN - WINDOW));
+			}
+		}
+		std::cout << "+ Parallel churn in a small table passed, buckets " << churn.max_bucket_count() << "\n";
+
+		// 8.4 Длина пробинга внутри шарда: номер шарда не должен зависеть от битов,
+		// по которым таблица шарда выбирает ячейку (здесь - PowerOfTwoSizePolicy)
+		if constexpr (std::is_same_v<HashTable, ConcurrentShardedHashTable<OpenHashTable<int, std::string>>>) {
+			const size_t SHARDS = 16;
+			const int PER_SHARD = 3000;
+			ConcurrentShardedHashTable<OpenHashTable<int, std::string, PowerOfTwoSizePolicy>> sharded(SHARDS * 4096, SHARDS);
+			OpenHashTable<int, std::string, PowerOfTwoSizePolicy> single(4096);
+			for (int i = 0; i != static_cast<int>(SHARDS) * PER_SHARD; ++i) {
+				sharded.insert(i, std::to_string(i));
+				if (i < PER_SHARD) single.insert(i, std::to_string(i));
+			}
+			assert(sharded.max_bucket_count() == SHARDS * single.max_bucket_count());
+			assert(sharded.average_probe_length() < 1.5 * single.average_probe_length() + 0.5);
+			std::cout << "+ Probe length inside shards " << sharded.average_probe_length()
+				<< " (one table: " << single.average_probe_length() << ")\n";
+		}
+
+		std::cout << "++ Concurrency test completed\n\n";
+	}
+
+	// Тест пакетных операций
+	static void test_batch() {
+		std::cout << "\n9. BATCH OPERATIONS TEST\n";
+		std::cout << "------------------\n";
+
+		// 9.1 Результаты совпадают с поэлементными операциями
+		const int N = 100000;
+		HashTable table(1024);
+		std::vector<std::pair<int, std::string>> items;
+		for (int i = 0; i < N; i += 2) {
+			items.emplace_back(i, std::to_string(i));
+		}
+		items.emplace_back(0, "dup"); // дубликат не вставляется
+		size_t inserted = table.insert_batch(items);
+		assert(inserted == static_cast<size_t>(N / 2));
+		assert(table.size() == static_cast<size_t>(N / 2));
+
+		std::vector<int> keys(N);
+		std::iota(keys.begin(), keys.end(), 0);
+		std::vector<std::string*> found(N);
+		std::vector<const std::string*> found_const(N);
+		auto present = std::make_unique<bool[]>(N);
+
+		table.find_batch(keys, found);
+		std::as_const(table).find_batch(keys, found_const);
+		size_t found_count = table.contains_batch(keys, std::span<bool>(present.get(), N));
+		assert(found_count == static_cast<size_t>(N / 2));
+		for (int i = 0; i != N; ++i) {
+			assert(found[i] == table.find(i));
+			assert(found_const[i] == found[i]);
+			assert(present[i] == (i % 2 == 0));
+		}
+		assert(*found[0] == "0");
+		std::cout << "+ Batch results match single operations\n";
+
+		std::cout << "++ Batch operations test completed\n\n";
+	}
+
+	// Сравнение хеш-функций на "неудобных" ключах
+	static void test_hashers() {
+		std::cout << "\n10. HASHERS TEST\n";
+		std::cout << "------------------\n";
+
+		// 10.1 Целые ключи: подряд и с шагом 1024, размер - степень двойки
+		const int N = 1 << 17;
+		std::vector<int> sequential(N);
+		std::vector<int> strided(N);
+		for (int i = 0; i != N; ++i) {
+			sequential[i] = i;
+			strided[i] = i * 1024;
+		}
+		for (const auto& [pattern, keys] : { std::pair{ "sequential", &sequential }, std::pair{ "stride 1024", &strided } }) {
+			std::cout << "  " << pattern << " keys:\n";
+			hasher_run<int, std::hash<int>>("std::hash", *keys);
+			hasher_run<int, MurmurHash<int>>("MurmurHash", *keys);
+			hasher_run<int, WyHash<int>>("WyHash", *keys);
+		}
+
+		// 10.2 Строковые ключи
+		std::vector<std::string> words(N);
+		for (int i = 0; i != N; ++i) {
+			words[i] = "user:" + std::to_string(i) + ":session";
+		}
+		std::cout << "  string keys:\n";
+		hasher_run<std::string, std::hash<std::string>>("std::hash", words);
+		hasher_run<std::string, StringHash>("StringHash", words);
+
+		// 10.3 StringHash принимает std::string, std::string_view и const char*
+		assert(StringHash{}(std::string("abc")) == StringHash{}(std::string_view("abc")));
+		assert(StringHash{}("abc") == StringHash{}(std::string("abc")));
+		assert(StringHash{}("abc") != StringHash{}("abd"));
+		assert(StringHash{}(std::string(40, 'x')) != StringHash{}(std::string(41, 'x')));
+		std::cout << "++ Hashers test completed\n\n";
+	}
+
+	// заполнение таблицы с хеш-функцией Hash и средняя длина пробинга
+	// (время поиска с разными хеш-функциями меряет HashTablesBench)
+	template <typename Key, typename Hash>
+	static void hasher_run(const std::string& name, const std::vector<Key>& keys) {
+		OpenHashTable<Key, int, ModuloSizePolicy, Hash> table(1 << 19);
+		for (size_t i = 0; i != keys.size(); ++i) {
+			table.insert(keys[i], static_cast<int>(i));
+		}
+		assert(table.size() == keys.size());
+		for (size_t i = 0; i != keys.size(); ++i) {
+			const int* value = table.find(keys[i]);
+			assert(value && *value == static_cast<int>(i));
+		}
+		// перемешивающие хеш-функции при заполнении 1/4 почти не дают коллизий
+		assert((std::is_same_v<Hash, std::hash<Key>> || table.average_probe_length() < 2.0));
+
+		std::cout << "    " << name << ": buckets " << table.max_bucket_count()
+			<< ", average probe length " << table.average_probe_length() << "\n";
+	}
+
+	// Тест поиска std::string-ключей по std::string_view и const char*
+	static void test_transparent_lookup() {
+		std::cout << "\n11. TRANSPARENT LOOKUP TEST\n";
+		std::cout << "------------------\n";
+
+		// та же реализация, но со строковыми ключами и прозрачными Hash/KeyEqual
+		using StringTable = std::conditional_t<std::is_same_v<HashTable, ChainHashTable<int, std::string>>,
+			ChainHashTable<std::string, int, ModuloSizePolicy, StringHash, std::equal_to<>>,
+			OpenHashTable<std::string, int, ModuloSizePolicy, StringHash, std::equal_to<>>>;
+
+		// 11.1 Результаты совпадают с поиском по std::string
+		const int N = 100000;
+		StringTable table(1024);
+		std::vector<std::string> words(N);
+		for (int i = 0; i != N; ++i) {
+			words[i] = "route/" + std::to_string(i) + "/handler";
+			table.insert(words[i], i);
+		}
+		for (int i = 0; i != N; ++i) {
+			std::string_view view = words[i];
+			assert(table.contains(view));
+			assert(table.find(view) == table.find(words[i]));
+			assert(std::as_const(table).at(view) == i);
+		}
+		assert(table.contains("route/0/handler"));
+		assert(!table.contains("route/-1/handler"));
+		assert(table.find(std::string_view("route/1/handle")) == nullptr);
+		try {
+			table.at("missing");
+			assert(false);
+		}
+		catch (const std::out_of_range&) {}
+		bool removed = table.remove(std::string_view(words[0]));
+		assert(removed);
+		removed = table.remove("route/0/handler");
+		assert(!removed);
+		assert(table.size() == static_cast<size_t>(N - 1));
+
+		// через интерфейс ключ преобразуется в std::string
+		IHashTable<std::string, int>& base = table;
+		assert(base.contains(std::string_view(words[1])));
+		assert(base.find("route/2/handler") == table.find(words[2]));
+		std::cout << "+ Lookup by string_view and const char* matches lookup by string\n";
+
+		// 11.2 Длинные ключи: поиск по string_view и по временной строке находят одно и то же
+		std::vector<std::string> long_words(N);
+		StringTable long_table(1024);
+		for (int i = 0; i != N; ++i) {
+			long_words[i] = std::string(48, 'k') + std::to_string(i);
+			long_table.insert(long_words[i], i);
+		}
+		size_t view_hits = 0;
+		for (const std::string& word : long_words) {
+			std::string_view view = word;
+			assert(long_table.find(view) == long_table.find(std::string(view)));
+			view_hits += long_table.contains(view);
+		}
+		assert(view_hits == static_cast<size_t>(N));
+		std::cout << "+ Long keys found by string_view\n";
+		std::cout << "++ Transparent lookup test completed\n\n";
+	}
+
+	// Значение, считающее свои копирования и перемещения
+	struct Tracked {
+		static inline int copies = 0;
+		static inline int moves = 0;
+
+		std::string text;
+
+		Tracked() = default;
+		explicit Tracked(std::string t) : text(std::move(t)) {}
+		Tracked(const std::string& a, const std::string& b) : text(a + b) {}
+		Tracked(const Tracked& other) : text(other.text) { ++copies; }
+		Tracked(Tracked&& other) noexcept : text(std::move(other.text)) { ++moves; }
+		Tracked& operator=(const Tracked& other) { text = other.text; ++copies; return *this; }
+		Tracked& operator=(Tracked&& other) noexcept { text = std::move(other.text); ++moves; return *this; }
+
+		static void reset() { copies = 0; moves = 0; }
+	};
+
+	// Тест emplace / try_emplace / insert_or_assign
+	static void test_emplace() {
+		std::cout << "\n12. EMPLACE TEST\n";
+		std::cout << "------------------\n";
+
+		// 12.1 insert_or_assign через интерфейс - для любой таблицы
+		HashTable table(16);
+		IntStringTable& base = table;
+		bool added = base.insert_or_assign(1, std::string("one"));
+		assert(added);
+		std::string two = "two";
+		added = base.insert_or_assign(2, two);
+		assert(added);
+		added = base.insert_or_assign(1, std::string("uno"));
+		assert(!added);
+		added = base.insert_or_assign(2, std::string("dos"));
+		assert(!added);
+		assert(base.at(1) == "uno" && base.at(2) == "dos");
+		assert(base.size() == 2);
+		for (int i = 0; i != 1000; ++i) {
+			added = base.insert_or_assign(i + 10, std::to_string(i));
+			assert(added);
+		}
+		for (int i = 0; i != 1000; ++i) {
+			added = base.insert_or_assign(i + 10, std::to_string(-i));
+			assert(!added);
+			assert(base.at(i + 10) == std::to_string(-i));
+		}
+		std::cout << "+ insert_or_assign inserts new keys and replaces existing values\n";
+
+		// 12.2 try_emplace и emplace (ChainHashTable, OpenHashTable)
+		if constexpr (requires(HashTable& t) { t.try_emplace(0, "x"); }) {
+			auto [value, inserted] = table.try_emplace(3, 5, 'x');
+			assert(inserted && *value == "xxxxx");
+			auto [same, again] = table.try_emplace(3, "ignored");
+			assert(!again && same == table.find(3) && *same == "xxxxx");
+			auto [empty, created] = table.emplace(4.0, "");
+			assert(created && empty->empty() && table.contains(4));
+			std::cout << "+ try_emplace constructs the value only for a new key\n";
+
+			// значение строится на месте и никогда не копируется
+			using TrackedTable = std::conditional_t<std::is_same_v<HashTable, ChainHashTable<int, std::string>>,
+				ChainHashTable<int, Tracked>, OpenHashTable<int, Tracked>>;
+			TrackedTable tracked(4);
+			Tracked::reset();
+			for (int i = 0; i != 1000; ++i) {
+				tracked.try_emplace(i, "value ", std::to_string(i));
+			}
+			int emplace_moves = Tracked::moves;
+			Tracked::reset();
+			for (int i = 0; i != 1000; ++i) {
+				tracked.try_emplace(i, "never built");
+				tracked[i].text += "!";
+			}
+			assert(Tracked::copies == 0 && Tracked::moves == 0);
+
+			Tracked::reset();
+			for (int i = 1000; i != 2000; ++i) {
+				tracked.insert(i, Tracked(std::to_string(i)));
+				tracked.insert_or_assign(i, Tracked("replaced"));
+			}
+			assert(Tracked::copies == 0);
+			assert(tracked.at(1500).text == "replaced" && tracked.at(500).text == "value 500!");
+			std::cout << "+ No value copies on emplace/insert/insert_or_assign (value moves: "
+				<< emplace_moves << ")\n";
+		}
+		std::cout << "++ Emplace test completed\n\n";
+	}
+
+	// Тест обхода элементов итераторами
+	static void test_iteration() {
+		std::cout << "\n13. ITERATION TEST\n";
+		std::cout << "------------------\n";
+
+		// 13.1 Каждый элемент встречается ровно один раз
+		const int N = 10000;
+		HashTable table(64);
+		for (int i = 0; i != N; ++i) {
+			table.insert(i, std::to_string(i));
+		}
+		for (int i = 0; i < N; i += 3) {
+			table.remove(i);
+		}
+		std::set<int> seen;
+		for (auto [key, value] : table) {
+			assert(value == std::to_string(key));
+			assert(key % 3 != 0);
+			bool unique = seen.insert(key).second;
+			assert(unique);
+		}
+		assert(seen.size() == table.size());
+
+		const IntStringTable& base = table;
+		size_t visited = 0;
+		for (auto it = base.begin(); it != base.end(); ++it) {
+			assert(it->second == std::to_string(it->first));
+			++visited;
+		}
+		assert(visited == table.size());
+
+		for (auto [key, value] : table) {
+			value += "!";
+		}
+		assert(table.at(1) == "1!");
+
+		HashTable empty(8);
+		assert(empty.begin() == empty.end());
+		assert(std::as_const(empty).begin() == std::as_const(empty).end());
+		std::cout << "+ Every element visited exactly once, values writable\n";
+
+		// 13.2 Порядок вставки и плотный обход (OrderedHashTable)
+		if constexpr (requires(const HashTable& t) { t.index_width(); }) {
+			std::vector<int> keys(N);
+			std::iota(keys.begin(), keys.end(), 0);
+			std::shuffle(keys.begin(), keys.end(), std::mt19937(3));
+			HashTable ordered(8);
+			assert(ordered.index_width() == 1);
+			for (int key : keys) {
+				ordered.insert(key, std::to_string(key));
+			}
+			assert(ordered.index_width() == 2);
+			size_t i = 0;
+			for (auto [key, value] : ordered) {
+				assert(key == keys[i++]);
+			}
+			assert(i == keys.size());
+
+			// удаление: на место удаленной записи встает последняя
+			ordered.remove(keys[0]);
+			assert(ordered.begin()->first == keys.back());
+
+			// плотный обход и обход через интерфейс видят одни и те же элементы
+			size_t dense_sum = 0;
+			for (auto [key, value] : ordered) {
+				dense_sum += key + value.size();
+			}
+			const IntStringTable& ordered_base = ordered;
+			size_t virtual_sum = 0;
+			for (auto [key, value] : ordered_base) {
+				virtual_sum += key + value.size();
+			}
+			assert(dense_sum == virtual_sum);
+			std::cout << "+ Insertion order kept, index width grows with capacity\n";
+		}
+		std::cout << "++ Iteration test completed\n\n";
+	}
+
+	// Поиск через HashTableLike-шаблон (прямые вызовы) и через ссылку на IHashTable
+	static void test_static_interface() {
+		std::cout << "\n14. STATIC INTERFACE TEST\n";
+		std::cout << "-------------------------\n";
+
+		static_assert(HashTableLike<HashTable>);
+
+		const int N = 4096;
+		HashTable table(N);
+		for (int i = 0; i != N; ++i) {
+			table.insert(i, std::to_string(i));
+		}
+		// половина ключей - промахи
+		std::mt19937 g(11);
+		std::uniform_int_distribution<int> dist(0, 2 * N - 1);
+		std::vector<int> keys(N);
+		for (int& key : keys) key = dist(g);
+
+		// адаптер сравнивается с таблицей внутри него
+		const auto& direct = [&]() -> const auto& {
+			if constexpr (requires { table.get(); }) return table.get();
+			else return table;
+		}();
+		const IntStringTable& base = table;
+
+		size_t static_hits = count_hits(direct, keys);
+		size_t virtual_hits = count_hits_virtual(base, keys);
+		assert(static_hits == virtual_hits);
+		assert(static_hits > 0 && static_hits < keys.size());
+		std::cout << "+ Static and virtual lookups agree (" << static_hits << " hits)\n";
+		std::cout << "++ Static interface test completed\n\n";
+	}
+
+	// Тест stats(): структура таблицы и счетчики CountingStats
+	template <typename CountingTable>
+	static void test_stats() {
+		std::cout << "\n15. STATS TEST\n";
+		std::cout << "--------------\n";
+
+		const int N = 10000;
+		CountingTable table(64);
+		for (int i = 0; i != N; ++i) {
+			table.insert(i * 7, std::to_string(i));
+		}
+		table.insert(0, "duplicate");
+		for (int i = 0; i != N; ++i) {
+			assert(table.contains(i * 7));
+			assert(!table.contains(i * 7 + 1));
+		}
+		TableStats stats = table.stats();
+		assert(stats.counting);
+		assert(stats.size == N && stats.buckets == table.max_bucket_count());
+		assert(stats.inserts == N);
+		assert(stats.hits() == N && stats.misses() == N);
+		assert(stats.hit_probes[0] == 0);
+		assert(stats.rehashes > 0);
+		assert(stats.max_chain_length >= 1);
+		assert(stats.average_chain_length >= 1 && stats.average_chain_length <= stats.max_chain_length);
+		assert(stats.empty_bucket_ratio >= 0 && stats.empty_bucket_ratio <= 1);
+		std::cout << "  After " << N << " inserts: " << stats.rehashes << " rehashes in "
+			<< std::chrono::duration_cast<std::chrono::microseconds>(stats.rehash_time).count() << " us, "
+			<< "empty buckets " << stats.empty_bucket_ratio << ", chain/probe length avg "
+			<< stats.average_chain_length << " max " << stats.max_chain_length << "\n";
+		std::cout << "  Probes per hit " << TableStats::average(stats.hit_probes)
+			<< ", per miss " << TableStats::average(stats.miss_probes) << "\n";
+
+		// удаления, надгробия и пакетный поиск
+		for (int i = 0; i < N; i += 2) {
+			table.remove(i * 7);
+		}
+		std::vector<int> keys(N);
+		for (int i = 0; i != N; ++i) keys[i] = i * 7;
+		auto present = std::make_unique<bool[]>(N);
+		size_t hits = table.contains_batch(keys, std::span<bool>(present.get(), N));
+		stats = table.stats();
+		assert(stats.removes == N / 2);
+		assert(stats.lookups() == 3 * static_cast<uint64_t>(N));
+		assert(hits == N / 2 && stats.hits() == N + hits);
+		if constexpr (requires { table.tombstone_count(); }) {
+			assert(stats.tombstones == table.tombstone_count());
+		}
+		std::cout << "  After " << N / 2 << " removes: tombstones " << stats.tombstones << "\n";
+
+		table.reset_stats();
+		assert(table.stats().lookups() == 0 && table.stats().inserts == 0);
+
+		// без CountingStats счетчиков нет, структура считается
+		HashTable plain(64);
+		plain.insert(1, "one");
+		assert(plain.contains(1));
+		TableStats plain_stats = plain.stats();
+		assert(!plain_stats.counting && plain_stats.lookups() == 0);
+		assert(plain_stats.size == 1 && plain_stats.empty_buckets == plain_stats.buckets - 1);
+		std::cout << "++ Stats test completed\n\n";
+	}
+
+	// Тест memory_usage(); для ChainHashTable и OpenHashTable - сверка с CountingAllocator
+	static void test_memory() {
+		std::cout << "\n16. MEMORY TEST\n";
+		std::cout << "---------------\n";
+
+		const int N = 100000;
+		HashTable table(64);
+		size_t empty_bytes = table.memory_usage();
+		assert(empty_bytes > sizeof(HashTable));
+		for (int i = 0; i != N; ++i) {
+			table.insert(i, std::to_string(i)); // короткие строки - без своей памяти
+		}
+		size_t bytes = table.memory_usage();
+		assert(bytes >= empty_bytes + N * (sizeof(int) + sizeof(std::string)));
+		std::cout << "  " << N << " entries: " << bytes << " bytes, "
+			<< static_cast<double>(bytes) / N << " bytes/entry at load factor " << table.load_factor() << "\n";
+
+		if constexpr (std::is_same_v<HashTable, ChainHashTable<int, std::string>>) {
+			check_allocator<ChainHashTable<int, std::string, ModuloSizePolicy, std::hash<int>, std::equal_to<int>, NoStats,
+				CountingAllocator<std::pair<const int, std::string>, HashTable>>>();
+		}
+		if constexpr (std::is_same_v<HashTable, OpenHashTable<int, std::string>>) {
+			check_allocator<OpenHashTable<int, std::string, ModuloSizePolicy, std::hash<int>, std::equal_to<int>, NoStats,
+				CountingAllocator<std::pair<const int, std::string>, HashTable>>>();
+			check_allocator<OpenHashTable<int, std::string, ModuloSizePolicy, std::hash<int>, std::equal_to<int>, NoStats,
+				CountingAllocator<std::pair<const int, std::string>, HashTable>, SplitLayout>>();
+		}
+		std::cout << "++ Memory test completed\n\n";
+	}
+
+	// Тест раздельного расположения ячеек (SplitLayout) против записей целиком
+	static void test_layout() {
+		std::cout << "\n17. LAYOUT TEST\n";
+		std::cout << "---------------\n";
+
+		using Payload = std::array<uint64_t, 8>; // значение на целую строку кэша
+		using Interleaved = OpenHashTable<int, Payload, PowerOfTwoSizePolicy>;
+		using Split = OpenHashTable<int, Payload, PowerOfTwoSizePolicy, std::hash<int>, std::equal_to<int>, NoStats,
+			std::allocator<std::pair<const int, Payload>>, SplitLayout>;
+
+		// 17.1 Одинаковое поведение при вставках, удалениях, переносе и уплотнении
+		const int N = 1 << 17;
+		Interleaved interleaved(16, 0, 1, 0.8, RehashMode::INCREMENTAL);
+		Split split(16, 0, 1, 0.8, RehashMode::INCREMENTAL);
+		std::mt19937 g(7);
+		std::vector<int> keys(N);
+		for (int& key : keys) key = static_cast<int>(g() >> 1);
+		for (int key : keys) {
+			Payload value{};
+			value[0] = static_cast<uint64_t>(key);
+			bool inserted = interleaved.insert(key, value);
+			bool split_inserted = split.insert(key, value);
+			assert(inserted == split_inserted);
+		}
+		for (size_t i = 0; i < keys.size(); i += 3) {
+			bool removed = interleaved.remove(keys[i]);
+			bool split_removed = split.remove(keys[i]);
+			assert(removed == split_removed);
+		}
+		split.compact();
+		assert(interleaved.size() == split.size());
+		for (int key : keys) {
+			const Payload* a = interleaved.find(key);
+			const Payload* b = split.find(key);
+			assert((a == nullptr) == (b == nullptr));
+			assert(!b || (*b)[0] == static_cast<uint64_t>(key));
+		}
+		size_t visited = 0;
+		for (auto [key, value] : split) {
+			assert(value[0] == static_cast<uint64_t>(key));
+			++visited;
+		}
+		assert(visited == split.size());
+		std::cout << "+ Split layout matches interleaved layout\n";
+
+		// 17.2 Промахи при высоком заполнении
+		Interleaved dense_interleaved(N, 0, 1, 0.8);
+		Split dense_split(N, 0, 1, 0.8);
+		for (int i = 0; i != N * 3 / 4; ++i) {
+			dense_interleaved.insert(keys[i], Payload{});
+			dense_split.insert(keys[i], Payload{});
+		}
+		for (int i = 0; i != N; ++i) {
+			int miss = -static_cast<int>(g() >> 2) - 1;
+			assert(!dense_interleaved.contains(miss));
+			assert(!dense_split.contains(miss));
+		}
+		std::cout << "+ Misses at load factor " << dense_split.load_factor() << " agree\n";
+		std::cout << "  Memory: interleaved " << dense_interleaved.memory_usage() << " bytes, split "
+			<< dense_split.memory_usage() << " bytes\n";
+		std::cout << "++ Layout test completed\n\n";
+	}
+
+	// Тест insert_bulk: тот же результат, что у вставок по одному, при любом числе потоков
+	static void test_bulk_load() {
+		std::cout << "\n18. BULK LOAD TEST\n";
+		std::cout << "------------------\n";
+
+		// 18.1 Повторы, уже имеющиеся ключи и надгробия
+		const int N = 200000;
+		std::mt19937 g(11);
+		std::uniform_int_distribution<int> dist(0, N);
+		std::vector<std::pair<int, std::string>> items(N);
+		for (int i = 0; i != N; ++i) {
+			int key = dist(g);
+			items[i] = { key, std::to_string(key) + "/" + std::to_string(i) };
+		}
+		auto prepared = []() {
+			HashTable table(64);
+			for (int key = 0; key < N; key += 7) table.insert(key, std::string("old"));
+			for (int key = 0; key < N; key += 21) table.remove(key);
+			return table;
+		};
+		HashTable expected = prepared();
+		size_t expected_inserted = 0;
+		for (const auto& [key, value] : items) {
+			expected_inserted += expected.insert(key, value);
+		}
+		for (size_t threads : { 1, 2, 4, 7 }) {
+			HashTable table = prepared();
+			size_t inserted = table.insert_bulk(items, threads);
+			assert(inserted == expected_inserted);
+			assert(table.size() == expected.size());
+			for (int key = 0; key <= N; ++key) {
+				const std::string* value = table.find(key);
+				const std::string* reference = expected.find(key);
+				assert((value == nullptr) == (reference == nullptr));
+				assert(!value || *value == *reference);
+			}
+			size_t visited = 0;
+			for (auto it = table.begin(); it != table.end(); ++it) ++visited;
+			assert(visited == table.size());
+			assert(table.insert_bulk(items, threads) == 0); // второй раз - только повторы
+		}
+		std::cout << "+ Bulk load matches sequential inserts: " << expected_inserted << " of " << N
+			<< " items inserted with 1, 2, 4 and 7 threads\n";
+
+		std::cout << "++ Bulk load test completed\n\n";
+	}
+
+	// Тест rehash(size, threads): содержимое сохраняется при любом числе потоков
+	static void test_parallel_rehash() {
+		std::cout << "\n19. PARALLEL REHASH TEST\n";
+		std::cout << "------------------------\n";
+
+		// 19.1 Рост и сжатие в разном числе потоков, с надгробиями
+		const int N = 150000;
+		HashTable table(64);
+		for (int i = 0; i != N; ++i) {
+			table.insert(i * 7, std::to_string(i));
+		}
+		for (int i = 0; i < N; i += 5) {
+			table.remove(i * 7);
+		}
+		const size_t expected = table.size();
+		for (size_t threads : { 4, 1, 7, 2 }) {
+			table.rehash(table.max_bucket_count() * 2, threads);
+			assert(table.size() == expected);
+			for (int i = 0; i != N; ++i) {
+				const std::string* value = table.find(i * 7);
+				assert((value != nullptr) == (i % 5 != 0));
+				assert(!value || *value == std::to_string(i));
+			}
+			size_t visited = 0;
+			for (auto it = table.begin(); it != table.end(); ++it) ++visited;
+			assert(visited == expected);
+		}
+		bool inserted = table.insert(-1, std::string("after"));
+		assert(inserted && *table.find(-1) == "after");
+		std::cout << "+ Rehash with 1, 2, 4 and 7 threads keeps " << expected << " entries\n";
+
+		std::cout << "++ Parallel rehash test completed\n\n";
+	}
+
+	// ==================== 20. Снимки ====================
+	static void test_snapshot() {
+		std::cout << "\n20. SNAPSHOT TEST\n";
+		std::cout << "-----------------\n";
+
+		// 20.1 Потоковый снимок строк, в том числе посреди постепенного переноса
+		HashTable source(16, 0, 1, 0.75, RehashMode::INCREMENTAL);
+		const int N = 20000;
+		for (int i = 0; i != N; ++i) {
+			source.insert(i, std::string(i % 50, 'x') + std::to_string(i));
+		}
+		for (int i = 0; i < N; i += 4) {
+			source.remove(i);
+		}
+		for (int i = N; !source.migrating(); ++i) { // снимок посреди переноса
+			source.insert(i, std::to_string(i));
+		}
+		std::stringstream stream;
+		source.save(stream);
+		HashTable restored = HashTable::load(stream);
+		assert(!restored.migrating());
+		verify_equality(source, restored, gen_data(2 * N), "Stream snapshot");
+		assert(restored.get_max_load_factor() == source.get_max_load_factor());
+		std::cout << "+ Stream snapshot restores strings\n";
+
+		// 20.2 Образ: load и map для обоих расположений ячеек
+		using Image = OpenHashTable<int, uint64_t>;
+		using SplitImage = OpenHashTable<int, uint64_t, ModuloSizePolicy, std::hash<int>, std::equal_to<int>, NoStats,
+			std::allocator<std::pair<const int, uint64_t>>, SplitLayout>;
+		const std::string path = (std::filesystem::temp_directory_path() / "hashtable_snapshot_test.bin").string();
+		check_image<Image>(path);
+		check_image<SplitImage>(path);
+		std::cout << "+ Image snapshots load and map for both layouts\n";
+
+		// образ записей целиком не зависит от мусора в памяти таблицы: выравнивание
+		// и свободные ячейки пишутся нулями
+		using DirtyImage = OpenHashTable<int, uint64_t, ModuloSizePolicy, std::hash<int>, std::equal_to<int>, NoStats,
+			DirtyAllocator<std::pair<const int, uint64_t>>>;
+		Image clean(1000);
+		DirtyImage dirty(1000);
+		for (int i = 0; i != 500; ++i) {
+			clean.insert(i * 7, static_cast<uint64_t>(i));
+			dirty.insert(i * 7, static_cast<uint64_t>(i));
+		}
+		std::stringstream clean_image, dirty_image;
+		clean.save(clean_image);
+		dirty.save(dirty_image);
+		assert(clean_image.str() == dirty_image.str());
+		std::cout << "+ Image snapshots are byte-reproducible\n";
+
+		// 20.3 Поврежденные и чужие снимки отвергаются
+		auto rejected = [](auto&& action) {
+			try {
+				action();
+				return false;
+			}
+			catch (const std::runtime_error&) {
+				return true;
+			}
+		};
+		{
+			Image image(64);
+			for (int i = 0; i != 1000; ++i) image.insert(i, static_cast<uint64_t>(i));
+			image.save(path);
+		}
+		assert(rejected([&] { OpenHashTable<int, uint32_t>::map(path); }));
+		assert(rejected([&] { SplitImage::load(path); }));
+		assert(rejected([&] { HashTable::load(path); }));
+		{
+			std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+			const auto middle = static_cast<std::streamoff>(std::filesystem::file_size(path) / 2);
+			file.seekg(middle);
+			char byte = static_cast<char>(file.get());
+			file.seekp(middle);
+			file.put(static_cast<char>(~byte));
+		}
+		assert(rejected([&] { Image::map(path); }));
+		assert(rejected([&] { Image::load(path); }));
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+		assert(rejected([&] { Image::map(path, false); }));
+		assert(rejected([&] { Image::load(path); }));
+		std::stringstream garbage("not a snapshot at all, definitely not a snapshot at all, not at all"
+			"not a snapshot at all, definitely not a snapshot at all, not at all");
+		assert(rejected([&] { HashTable::load(garbage); }));
+		std::cout << "+ Corrupted, truncated and mistyped snapshots are rejected\n";
+
+		std::filesystem::remove(path);
+		std::cout << "++ Snapshot test completed\n\n";
+	}
+
+	// Аллокатор, оставляющий в выделенной памяти мусор: элементы без аргументов
+	// инициализируются по умолчанию, а не значением
+	template <typename T>
+	struct DirtyAllocator {
+		using value_type = T;
+
+		DirtyAllocator() = default;
+		template <typename U>
+		DirtyAllocator(const DirtyAllocator<U>&) noexcept {}
+
+		T* allocate(size_t n) {
+			T* p = std::allocator<T>{}.allocate(n);
+			std::memset(static_cast<void*>(p), 0xCD, n * sizeof(T));
+			return p;
+		}
+		void deallocate(T* p, size_t n) noexcept { std::allocator<T>{}.deallocate(p, n); }
+
+		template <typename U>
+		void construct(U* p) { ::new (static_cast<void*>(p)) U; }
+		template <typename U, typename... Args>
+		void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+		template <typename U>
+		bool operator==(const DirtyAllocator<U>&) const noexcept { return true; }
+	};
+
+	// образ таблицы Table: load и map совпадают с исходной таблицей
+	template <typename Table>
+	static void check_image(const std::string& path) {
+		Table table(16, 0, 1, 0.75, RehashMode::INCREMENTAL);
+		const int N = 30000;
+		for (int i = 0; i != N; ++i) {
+			table.insert(i * 5, static_cast<uint64_t>(i) * 11);
+		}
+		for (int i = 0; i < N; i += 3) {
+			table.remove(i * 5);
+		}
+		table.save(path);
+		Table loaded = Table::load(path);
+		auto mapped = Table::map(path);
+		assert(loaded.size() == table.size() && mapped.size() == table.size());
+		assert(loaded.max_bucket_count() == mapped.max_bucket_count());
+		for (int key = -1; key <= N * 5; ++key) {
+			const uint64_t* expected = table.find(key);
+			const uint64_t* a = loaded.find(key);
+			const uint64_t* b = mapped.find(key);
+			assert((expected == nullptr) == (a == nullptr) && (expected == nullptr) == (b == nullptr));
+			assert(!expected || (*expected == *a && *expected == *b));
+			assert(mapped.contains(key) == (expected != nullptr));
+		}
+		// снимок загруженной таблицы совпадает байт в байт
+		std::stringstream first, second;
+		loaded.save(first);
+		Table::load(first).save(second);
+		assert(first.str() == second.str());
+		bool inserted = loaded.insert(-7, 7);
+		assert(inserted && *loaded.find(-7) == 7);
+	}
+
+	// ==================== 21. Заморозка ====================
+	static void test_freeze() {
+		std::cout << "\n21. FREEZE TEST\n";
+		std::cout << "---------------\n";
+
+		// 21.1 Замороженная таблица находит те же ключи
+		const int N = 100000;
+		HashTable table(64);
+		for (int i = 0; i != N; ++i) {
+			table.insert(i * 3, std::to_string(i));
+		}
+		for (int i = 0; i < N; i += 4) {
+			table.remove(i * 3);
+		}
+		const auto frozen = table.freeze();
+		static_assert(ReadOnlyHashTableLike<std::remove_const_t<decltype(frozen)>>);
+		assert(frozen.size() == table.size() && frozen.max_bucket_count() == table.size());
+		assert(frozen.load_factor() == 1.0 && frozen.overflow_count() == 0);
+		for (int key = -1; key <= N * 3; ++key) {
+			const std::string* expected = table.find(key);
+			const std::string* value = frozen.find(key);
+			assert((expected == nullptr) == (value == nullptr));
+			assert(!value || *value == *expected);
+			assert(frozen.contains(key) == (expected != nullptr));
+		}
+		assert(frozen.at(3) == "1");
+		try {
+			frozen.at(0);
+			assert(false);
+		}
+		catch (const std::out_of_range&) {}
+		size_t visited = 0;
+		for (auto at = frozen.first_position(); at != TablePosition{}; at = frozen.next_position(at)) {
+			auto [key, value] = frozen.entry_at(at);
+			assert(*table.find(*key) == *value);
+			++visited;
+		}
+		assert(visited == table.size());
+		std::cout << "+ Frozen table matches the source: " << frozen.size() << " keys in "
+			<< frozen.max_bucket_count() << " slots\n";
+		std::cout << "  " << static_cast<double>(frozen.memory_usage()) / frozen.size() << " bytes/key ("
+			<< static_cast<double>(table.memory_usage()) / table.size() << " in the source), "
+			<< frozen.pilot_count() << " pilots\n";
+
+		// 21.2 Пустая таблица и ключи с одинаковым хешем
+		assert(HashTable(8).freeze().empty() && !HashTable(8).freeze().contains(1));
+		for (int count : { 1, 2 }) { // один и два ключа: всего два бакета, попадания и промахи
+			for (int first = -50; first != 50; ++first) {
+				HashTable few(8);
+				for (int i = 0; i != count; ++i) few.insert(first * 7919 + i, std::to_string(i));
+				const auto tiny = few.freeze();
+				assert(tiny.size() == static_cast<size_t>(count) && tiny.max_bucket_count() == tiny.size());
+				for (int i = 0; i != count; ++i) assert(tiny.at(first * 7919 + i) == std::to_string(i));
+				for (int miss = 1; miss != 20; ++miss) assert(!tiny.contains(first * 7919 - miss * 104729));
+			}
+		}
+		struct CoarseHash { // четыре ключа на одно значение хеша
+			size_t operator()(int key) const { return static_cast<size_t>(key / 4); }
+		};
+		std::vector<std::pair<int, std::string>> items;
+		for (int i = 0; i != 1000; ++i) items.emplace_back(i, std::to_string(i));
+		FrozenHashTable<int, std::string, CoarseHash> coarse(items);
+		assert(coarse.size() == 1000 && coarse.overflow_count() == 750);
+		for (int i = 0; i != 1000; ++i) assert(coarse.at(i) == std::to_string(i));
+		assert(!coarse.contains(-1) && !coarse.contains(1000));
+		items.emplace_back(5, "again");
+		try {
+			FrozenHashTable<int, std::string, CoarseHash> duplicate(items);
+			assert(false);
+		}
+		catch (const std::invalid_argument&) {}
+		std::cout << "+ Empty tables, equal hashes and duplicate keys\n";
+
+		std::cout << "++ Freeze test completed\n\n";
+	}
+
+	// ==================== 22. Таблица времени компиляции ====================
+	static void test_constexpr_table() {
+		std::cout << "\n22. CONSTEXPR TABLE TEST\n";
+		std::cout << "------------------------\n";
+
+		// 22.1 Содержимое и поиск вычисляются компилятором
+		static constexpr auto opcodes = make_constexpr_table<std::string_view, int>({
+			{ "nop", 0 }, { "load", 1 }, { "store", 2 }, { "add", 3 }, { "sub", 4 }, { "mul", 5 },
+			{ "div", 6 }, { "jmp", 7 }, { "call", 8 }, { "ret", 9 }, { "push", 10 }, { "pop", 11 } });
+		static_assert(opcodes.size() == 12 && opcodes.load_factor() < 0.5);
+		static_assert(opcodes.at("mul") == 5 && opcodes.value_or("halt", -1) == -1);
+		static_assert(!opcodes.contains("") && *opcodes.find("pop") == 11);
+		static_assert(ReadOnlyHashTableLike<std::remove_const_t<decltype(opcodes)>>);
+
+		static constexpr auto squares = make_constexpr_table<int, int, PowerOfTwoSizePolicy>({
+			{ 0, 0 }, { 1, 1 }, { 2, 4 }, { 3, 9 }, { 1024, 1 << 20 }, { 2048, 1 << 22 }, { -1, 1 } });
+		static_assert(squares.max_bucket_count() == 16 && squares.at(1024) == 1 << 20 && !squares.contains(4));
+		static constexpr auto primes = make_constexpr_table<int, char, PrimeSizePolicy>({ { 2, 'a' }, { 3, 'b' }, { 5, 'c' } });
+		static_assert(primes.at(5) == 'c' && !primes.contains(4));
+		std::cout << "+ Lookups evaluated at compile time for all size policies\n";
+
+		// 22.2 Те же ключи во время выполнения: совпадает с OpenHashTable, обход
+		OpenHashTable<std::string_view, int, ModuloSizePolicy, StringHash> runtime(16);
+		for (auto at = opcodes.first_position(); at != TablePosition{}; at = opcodes.next_position(at)) {
+			auto [key, value] = opcodes.entry_at(at);
+			bool inserted = runtime.insert(*key, *value);
+			assert(inserted);
+		}
+		assert(runtime.size() == opcodes.size());
+		std::vector<std::string> probes = { "nop", "load", "store", "add", "sub", "mul", "div", "jmp",
+			"call", "ret", "push", "pop", "halt", "loads", "", "ad", "x" };
+		for (const std::string& name : probes) {
+			const int* expected = runtime.find(name);
+			const int* value = opcodes.find(name);
+			assert((expected == nullptr) == (value == nullptr));
+			assert(!value || *value == *expected);
+		}
+		try {
+			opcodes.at(probes.back());
+			assert(false);
+		}
+		catch (const std::out_of_range&) {}
+		std::cout << "+ Runtime lookups match OpenHashTable\n";
+
+		std::cout << "++ Constexpr table test completed\n\n";
+	}
+
+	// memory_usage() совпадает с памятью, выделенной через аллокатор таблицы
+	template <typename CountedTable>
+	static void check_allocator() {
+		AllocationCounter& counter = allocation_counter<HashTable>();
+		counter.reset();
+		{
+			// память в куче: без самого объекта таблицы
+			auto heap = [](const CountedTable& t) { return t.memory_usage() - sizeof(CountedTable); };
+			CountedTable table(64);
+			assert(counter.bytes == heap(table));
+			for (int i = 0; i != 50000; ++i) {
+				table.insert(i, std::to_string(i));
+			}
+			assert(counter.bytes == heap(table));
+			for (int i = 0; i < 50000; i += 2) {
+				table.remove(i);
+			}
+			CountedTable copy(table);
+			assert(counter.bytes == heap(table) + heap(copy));
+			table.rehash(table.max_bucket_count() * 2);
+			assert(counter.bytes == heap(table) + heap(copy));
+			std::cout << "  Counting allocator: " << counter.bytes << " bytes live for two tables, peak "
+				<< counter.peak_bytes << ", " << counter.allocations << " allocations\n";
+		}
+		assert(counter.bytes == 0);
+		std::cout << "+ memory_usage() matches the counting allocator\n";
+	}
+
+	template <HashTableLike Table>
+	static size_t count_hits(const Table& table, const std::vector<int>& keys) {
+		size_t hits = 0;
+		for (int key : keys) {
+			if (const auto* value = table.find(key)) hits += value->size();
+		}
+		return hits;
+	}
+
+	static size_t count_hits_virtual(const IntStringTable& table, const std::vector<int>& keys) {
+		size_t hits = 0;
+		for (int key : keys) {
+			if (const auto* value = table.find(key)) hits += value->size();
+		}
+		return hits;
+	}
+
 	// ==================== Вспомогательные функции ====================	
 	//функция компплексного теста на единичном наборе данных
 	static void single_main_test(size_t M, size_t a = 0, size_t b = 1) {
@@ -234,15 +1510,20 @@ private:
 
 		std::cout << "Fill table --------------------------\n";
 		auto data = gen_data(M / 4 * 3);
+		auto max_latency = std::chrono::nanoseconds::zero();
 		auto start = std::chrono::high_resolution_clock::now();
 		for (auto item : data) {
+			auto op_start = std::chrono::high_resolution_clock::now();
 			bool success = table.insert(item.first, item.second);
+			max_latency = std::max(max_latency, std::chrono::high_resolution_clock::now() - op_start);
 			assert(success);
 		}
 		auto end = std::chrono::high_resolution_clock::now();
 		auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
 		std::cout << "  Table filled in " << duration.count() << " ms\n";
+		std::cout << "  Max single insert latency: "
+			<< std::chrono::duration_cast<std::chrono::microseconds>(max_latency).count() << " us\n";
 		std::cout << "  Size: " << table.size() << ", buckets " << table.max_bucket_count() << "\n";
 		std::cout << "  Load factor: " << table.load_factor() << "\n";
 
@@ -0,0 +1,78 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include <functional>
+#include <type_traits>
+#include "SizePolicy.h"
+
+// Хеш-функции для таблиц. std::hash для целых в libstdc++ и MSVC STL - тождественная
+// функция (или почти): последовательные и кратные ключи попадают в соседние или
+// периодически повторяющиеся ячейки, и пробинг по модулю M образует длинные цепочки.
+// Функции ниже перемешивают все биты ключа; все они без состояния, как std::hash
+
+// Финализатор murmur3 (fmix64): каждый бит входа влияет на все биты результата
+constexpr uint64_t murmur_mix(uint64_t h) {
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+// Константы и перемешивание wyhash: 128-битное произведение, свернутое xor
+constexpr uint64_t WY_P0 = 0xa0761d6478bd642fULL;
+constexpr uint64_t WY_P1 = 0xe7037ed1a0b428dbULL;
+constexpr uint64_t WY_P2 = 0x8ebc6af09c88c6e3ULL;
+
+constexpr uint64_t wy_mix(uint64_t a, uint64_t b) {
+	return mul_high_u64(a, b) ^ (a * b);
+}
+
+// std::hash, досмешанный финализатором murmur3: подходит для любого ключа со std::hash
+template <typename T>
+struct MurmurHash {
+	size_t operator()(const T& key) const {
+		return static_cast<size_t>(murmur_mix(static_cast<uint64_t>(std::hash<T>{}(key))));
+	}
+};
+
+// wyhash для целых и перечислений: два умножения 64x64->128
+template <typename T> requires std::is_integral_v<T> || std::is_enum_v<T>
+struct WyHash {
+	constexpr size_t operator()(const T& key) const {
+		uint64_t x = static_cast<uint64_t>(key);
+		return static_cast<size_t>(wy_mix(wy_mix(x ^ WY_P0, WY_P1), WY_P2));
+	}
+};
+
+// Хеш строк в духе wyhash: по 16 байт за шаг, одно умножение на шаг.
+// Принимает std::string, std::string_view и const char* (is_transparent)
+struct StringHash {
+	using is_transparent = void;
+
+	constexpr size_t operator()(std::string_view s) const {
+		size_t n = s.size();
+		size_t i = 0;
+		uint64_t seed = WY_P0;
+		for (; n - i > 16; i += 16) {
+			seed = wy_mix(load(s, i, 8) ^ WY_P1, load(s, i + 8, 8) ^ seed);
+		}
+		// последние 1-16 байт
+		size_t rest = n - i;
+		uint64_t a = load(s, i, rest < 8 ? rest : 8);
+		uint64_t b = rest > 8 ? load(s, i + 8, rest - 8) : 0;
+		return static_cast<size_t>(wy_mix(WY_P1 ^ n, wy_mix(a ^ WY_P1, b ^ seed)));
+	}
+
+private:
+	// до 8 байт начиная с pos как little-endian число (компилятор сводит к одной загрузке)
+	static constexpr uint64_t load(std::string_view s, size_t pos, size_t count) {
+		uint64_t value = 0;
+		for (size_t k = 0; k < count; ++k) {
+			value |= static_cast<uint64_t>(static_cast<unsigned char>(s[pos + k])) << (8 * k);
+		}
+		return value;
+	}
+};
@@ -1,22 +1,87 @@
 ﻿#pragma once
 #include <concepts>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <iterator>
 
+// Хеш-функция для ключей T (без состояния, как std::hash)
+template<typename H, typename T>
+concept KeyHasher = std::default_initializable<H> && requires(const H& hash, const T& key) {
+	{ hash(key) } -> std::convertible_to<size_t>;
+};
+
+// Сравнение ключей T на равенство
+template<typename E, typename T>
+concept KeyEquality = std::default_initializable<E> && requires(const E& equal, const T& a, const T& b) {
+	{ equal(a, b) } -> std::convertible_to<bool>;
+};
+
+// Ключ, пригодный для хеш-функции и сравнения по умолчанию
 template<typename T>
-concept HashableKey = requires(T a, T b) {
-	{ std::hash<T>{}(a) } -> std::same_as<size_t>;
-	{ a == b } -> std::same_as<bool>;
+concept HashableKey = KeyHasher<std::hash<T>, T> && KeyEquality<std::equal_to<T>, T>;
+
+// Ключ другого типа Q, из которого можно построить K
+template<typename K, typename Q>
+concept KeyConvertible = !std::same_as<std::remove_cvref_t<Q>, K> && std::constructible_from<K, const Q&>;
+
+// Поиск по ключу другого типа Q без временного K: хеш-функция и сравнение
+// прозрачные (is_transparent) и принимают Q, например StringHash и std::equal_to<>
+template<typename Hash, typename KeyEqual, typename K, typename Q>
+concept TransparentLookup = !std::same_as<std::remove_cvref_t<Q>, K>
+	&& requires { typename Hash::is_transparent; typename KeyEqual::is_transparent; }
+	&& requires(const Hash& hash, const KeyEqual& equal, const K& key, const Q& other) {
+		{ hash(other) } -> std::convertible_to<size_t>;
+		{ equal(key, other) } -> std::convertible_to<bool>;
+	};
+
+// Позиция элемента при обходе таблицы: номер ячейки (бакета) и, если нужно, узел или массив
+struct TablePosition {
+	static constexpr size_t END = static_cast<size_t>(-1);
+
+	size_t slot = END;
+	const void* node = nullptr;
+
+	bool operator==(const TablePosition&) const = default;
 };
 
-template <typename K, typename V> requires HashableKey<K>
+// Интерфейс не зависит от способа хеширования: хеш-функцию и сравнение
+// ключей выбирают реализации (параметры Hash и KeyEqual)
+template <typename K, typename V>
 class IHashTable {
 
 public:	
+	using key_type = K;
+	using mapped_type = V;
+
+	virtual ~IHashTable() = default;
 	
 	//---------- Основные операции-------------------//
 	//Операции вставки
 	virtual bool insert(K key, const V& value) = 0;
 	virtual bool insert(K key, V&& value) = 0;
 
+	//вставка или замена значения; true, если ключ добавлен.
+	//По умолчанию - поиск и затем вставка, таблицы делают это за один проход
+	virtual bool insert_or_assign(K key, const V& value) {
+		if (V* current = find(key)) {
+			*current = value;
+			return false;
+		}
+		return insert(std::move(key), value);
+	}
+
+	virtual bool insert_or_assign(K key, V&& value) {
+		if (V* current = find(key)) {
+			*current = std::move(value);
+			return false;
+		}
+		return insert(std::move(key), std::move(value));
+	}
+
 	//операции удаления
 	virtual bool remove(const K& key) = 0;
 	
@@ -41,7 +106,7 @@ public:
 	//---------- Характeристики-------------------//
 
 	//максимальное число бакетов
-	virtual [[nodiscard]] size_t max_bucket_count() const noexcept = 0;
+	[[nodiscard]] virtual size_t max_bucket_count() const noexcept = 0;
 	
 	//фактический размер
 	virtual size_t size() const noexcept = 0;
@@ -50,4 +115,139 @@ public:
 
 	// Коэффициент заполнения
 	virtual double load_factor() const = 0;
+
+	//---------- Пакетные операции -------------------//
+	// results[i] - результат для keys[i]. По умолчанию ключи обрабатываются по одному;
+	// таблицы переопределяют их, чтобы промахи кэша по разным ключам перекрывались
+
+	virtual void find_batch(std::span<const K> keys, std::span<V*> results) {
+		check_batch(keys.size(), results.size());
+		for (size_t i = 0; i < keys.size(); ++i) {
+			results[i] = find(keys[i]);
+		}
+	}
+
+	virtual void find_batch(std::span<const K> keys, std::span<const V*> results) const {
+		check_batch(keys.size(), results.size());
+		for (size_t i = 0; i < keys.size(); ++i) {
+			results[i] = find(keys[i]);
+		}
+	}
+
+	//возвращает число найденных ключей
+	virtual size_t contains_batch(std::span<const K> keys, std::span<bool> results) const {
+		check_batch(keys.size(), results.size());
+		size_t found = 0;
+		for (size_t i = 0; i < keys.size(); ++i) {
+			results[i] = contains(keys[i]);
+			found += results[i];
+		}
+		return found;
+	}
+
+	//возвращает число вставленных пар
+	virtual size_t insert_batch(std::span<const std::pair<K, V>> items) {
+		size_t inserted = 0;
+		for (const auto& [key, value] : items) {
+			inserted += insert(key, value);
+		}
+		return inserted;
+	}
+
+	//---------- Поиск по ключу другого типа -------------------//
+	// Через интерфейс ключ типа Q (std::string_view, const char* для строк)
+	// преобразуется во временный K. ChainHashTable и OpenHashTable с прозрачными
+	// Hash и KeyEqual объявляют такие же перегрузки, которые ищут без него
+
+	template<typename Q> requires KeyConvertible<K, Q>
+	bool remove(const Q& key) { return remove(K(key)); }
+
+	template<typename Q> requires KeyConvertible<K, Q>
+	bool contains(const Q& key) const { return contains(K(key)); }
+
+	template<typename Q> requires KeyConvertible<K, Q>
+	V* find(const Q& key) { return find(K(key)); }
+
+	template<typename Q> requires KeyConvertible<K, Q>
+	const V* find(const Q& key) const { return find(K(key)); }
+
+	template<typename Q> requires KeyConvertible<K, Q>
+	V& at(const Q& key) { return at(K(key)); }
+
+	template<typename Q> requires KeyConvertible<K, Q>
+	const V& at(const Q& key) const { return at(K(key)); }
+
+	//---------- Обход -------------------//
+	// Обход не синхронизирован: пока он идет, таблицу нельзя изменять
+	using Position = TablePosition;
+
+	//позиция первого элемента; Position{} - элементов нет
+	virtual Position first_position() const = 0;
+	//позиция элемента, следующего за at
+	virtual Position next_position(Position at) const = 0;
+	//ключ и значение в позиции at
+	virtual std::pair<const K*, const V*> entry_at(Position at) const = 0;
+
+	// Итератор по элементам в порядке позиций; *it - пара ссылок {ключ, значение}
+	template<bool Const>
+	class BasicIterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::pair<const K, V>;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::pair<const K&, std::conditional_t<Const, const V&, V&>>;
+
+		struct pointer { //для it->first / it->second
+			reference ref;
+			const reference* operator->() const { return &ref; }
+		};
+
+		BasicIterator() = default;
+
+		//неконстантный итератор приводится к константному
+		operator BasicIterator<true>() const requires (!Const) { return BasicIterator<true>(table, pos); }
+
+		reference operator*() const {
+			auto [key, value] = table->entry_at(pos);
+			if constexpr (Const) return { *key, *value };
+			else return { *key, *const_cast<V*>(value) }; // таблица неконстантная
+		}
+		pointer operator->() const { return { **this }; }
+
+		BasicIterator& operator++() {
+			pos = table->next_position(pos);
+			return *this;
+		}
+		BasicIterator operator++(int) {
+			BasicIterator copy = *this;
+			++*this;
+			return copy;
+		}
+
+		bool operator==(const BasicIterator& other) const { return pos == other.pos; }
+
+	private:
+		friend class IHashTable;
+		template<bool> friend class BasicIterator;
+
+		BasicIterator(const IHashTable* t, Position p) : table(t), pos(p) {}
+
+		const IHashTable* table = nullptr;
+		Position pos;
+	};
+
+	using iterator = BasicIterator<false>;
+	using const_iterator = BasicIterator<true>;
+
+	iterator begin() { return iterator(this, first_position()); }
+	iterator end() { return iterator(this, Position{}); }
+	const_iterator begin() const { return const_iterator(this, first_position()); }
+	const_iterator end() const { return const_iterator(this, Position{}); }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+
+protected:
+	static void check_batch(size_t keys, size_t results) {
+		if (results < keys) throw std::invalid_argument("Batch results span is too small");
+	}
 };
\ No newline at end of file
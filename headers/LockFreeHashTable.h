@@ -0,0 +1,566 @@
+﻿#pragma once
+#include "IHashTable.h"
+#include <iostream>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <stdexcept>
+#include <numeric>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include "SizePolicy.h"
+
+// Неблокирующая хеш-таблица с открытой адресацией для нагрузки с преобладанием чтений.
+// Ячейки - атомарные указатели на узлы (ключ, значение), пробинг - та же квадратичная
+// схема с коэффициентами A и B, что и в OpenHashTable.
+//   - find/contains/get ничего не пишут в общую память и не ждут: не больше M проб на массив
+//   - insert занимает пустую ячейку через CAS, remove заменяет узел надгробием через CAS;
+//     надгробия не переиспользуются и исчезают при перестроении массива
+//   - при заполнении создается новый массив; писатели, заставшие перенос, помогают
+//     переносить его порциями и пишут в новый массив только после завершения переноса.
+//     Читатели перенос не ждут: перенесенные ячейки помечены MOVED и ведут в новый массив
+// Удаленные узлы и старые массивы освобождаются отложенно - в reclaim(), clear() и
+// деструкторе, которые нельзя вызывать одновременно с другими операциями. До этого
+// указатели из find остаются валидными; запись значения по ним не синхронизируется
+template <typename K, typename V, typename SizePolicy = ModuloSizePolicy,
+	typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+	requires KeyHasher<Hash, K> && KeyEquality<KeyEqual, K>
+class LockFreeHashTable final : public IHashTable<K, V> {
+
+public:
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using typename IHashTable<K, V>::Position;
+
+	//----------- Конструкторы -------------------//
+	LockFreeHashTable() = delete;
+
+	explicit LockFreeHashTable(size_t size, size_t a = 0, size_t b = 1, double mlf = 0.75l)
+		: A(a), B(b), max_load_factor(mlf) {
+
+		if (size == 0) throw std::invalid_argument("Size must be positive");
+		if (mlf <= 0 || mlf >= 1) {
+			throw std::invalid_argument("Max load factor must be in (0, 1)");
+		}
+
+		// Хотя бы один коэффициент должен быть ненулевым
+		if (A == 0 && B == 0) {
+			throw std::invalid_argument("At least one of A or B must be non-zero");
+		}
+
+		// Проверяем только ненулевые коэффициенты
+		size_t M = SizePolicy::round_size(size);
+		if (A != 0 && std::gcd(A, M) != 1) {
+			throw std::invalid_argument("A must be coprime with M or zero");
+		}
+		if (B != 0 && std::gcd(B, M) != 1) {
+			throw std::invalid_argument("B must be coprime with M or zero");
+		}
+		install(M);
+	}
+
+	// Копирование и перемещение - без конкурентной записи в участвующие таблицы
+	LockFreeHashTable(const LockFreeHashTable& other)
+		: A(other.A), B(other.B), max_load_factor(other.max_load_factor) {
+
+		// ячейка в ячейку: цепочки пробинга и надгробия те же, что в оригинале
+		const Array* source = other.current.load(std::memory_order_acquire);
+		install(source->M);
+		Array* target = current.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < source->M; ++i) {
+			Node* p = source->slots[i].load(std::memory_order_acquire);
+			if (holds_node(p)) {
+				p = new Node(untag(p)->key, untag(p)->value);
+				element_count.fetch_add(1, std::memory_order_relaxed);
+			}
+			target->slots[i].store(p, std::memory_order_relaxed);
+		}
+		target->used.store(source->used.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	LockFreeHashTable(LockFreeHashTable&& other) noexcept
+		: A(std::exchange(other.A, 0)),
+		B(std::exchange(other.B, 0)),
+		max_load_factor(other.max_load_factor),
+		current(other.current.exchange(nullptr)),
+		first(std::exchange(other.first, nullptr)),
+		retired_nodes(other.retired_nodes.exchange(nullptr)),
+		element_count(other.element_count.exchange(0))
+	{}
+
+	LockFreeHashTable& operator=(const LockFreeHashTable& other) {
+		if (this != &other) {
+			LockFreeHashTable copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	LockFreeHashTable& operator=(LockFreeHashTable&& other) noexcept {
+		if (this != &other) {
+			destroy();
+			A = std::exchange(other.A, 0);
+			B = std::exchange(other.B, 0);
+			max_load_factor = other.max_load_factor;
+			current = other.current.exchange(nullptr);
+			first = std::exchange(other.first, nullptr);
+			retired_nodes = other.retired_nodes.exchange(nullptr);
+			element_count = other.element_count.exchange(0);
+		}
+		return *this;
+	}
+	virtual ~LockFreeHashTable() {
+		destroy();
+	}
+
+	//---------- Основные операции-------------------//
+	//Операции вставки
+	bool insert(K key, const V& value) override {
+		return insert_node(key, [&]() { return new Node(std::move(key), value); }).second;
+	}
+
+	bool insert(K key, V&& value) override {
+		return insert_node(key, [&]() { return new Node(std::move(key), std::move(value)); }).second;
+	}
+
+	//операции удаления
+	bool remove(const K& key) override {
+		size_t hash = Hash{}(key);
+		for (;;) {
+			Array* a = current.load(std::memory_order_acquire);
+			if (a->next.load(std::memory_order_acquire) == nullptr) {
+				Attempt result = try_remove(a, hash, key);
+				if (result != Attempt::RETRY) return result == Attempt::SUCCESS;
+			}
+			help_migrate(a);
+		}
+	}
+
+	//операции доступа и поиска
+	bool contains(const K& key) const override {
+		return find_node(key) != nullptr;
+	}
+
+	V* find(const K& key) override {
+		Node* node = find_node(key);
+		return node ? &node->value : nullptr;
+	}
+
+	const V* find(const K& key) const override {
+		const Node* node = find_node(key);
+		return node ? &node->value : nullptr;
+	}
+
+	V& at(const K& key) override {
+		Node* node = find_node(key);
+		if (!node) throw std::out_of_range("Key not found in hash table");
+		return node->value;
+	}
+
+	const V& at(const K& key) const override {
+		const Node* node = find_node(key);
+		if (!node) throw std::out_of_range("Key not found in hash table");
+		return node->value;
+	}
+
+	// Только для неконстантных объектов
+	V& operator[](const K& key) override {
+		return insert_node(key, [&]() { return new Node(key, V{}); }).first->value;
+	}
+
+	//копия значения (безопасна, пока значения не меняют через find/at/operator[])
+	std::optional<V> get(const K& key) const {
+		const Node* node = find_node(key);
+		return node ? std::optional<V>(node->value) : std::nullopt;
+	}
+
+	//очистка - без конкурентных операций
+	void clear() override {
+		size_t M = current.load(std::memory_order_relaxed)->M;
+		destroy();
+		install(M);
+	}
+
+	//---------- Рехэширование -------------------//
+	// Потокобезопасно: перестроение идет тем же совместным переносом, что и рост
+	void rehash(size_t new_size) override {
+		if (new_size < max_bucket_count()) {
+			throw std::invalid_argument("rehash: new size too small");
+		}
+		for (;;) {
+			Array* a = current.load(std::memory_order_acquire);
+			if (a->M >= new_size && a->next.load(std::memory_order_acquire) == nullptr) return;
+			if (a->M < new_size) start_resize(a, new_size);
+			help_migrate(a);
+		}
+	}
+
+	// Освобождение удаленных узлов и старых массивов - без конкурентных операций
+	void reclaim() {
+		free_retired_nodes();
+		Array* a = current.load(std::memory_order_relaxed);
+		while (first != a) {
+			delete std::exchange(first, first->next.load(std::memory_order_relaxed));
+		}
+	}
+
+	//---------- Характeристики-------------------//
+
+	//максимальное число бакетов
+	[[nodiscard]] size_t max_bucket_count() const noexcept override {
+		const Array* a = current.load(std::memory_order_acquire);
+		return a ? a->M : 0;
+	}
+
+	//фактический размер (при конкурентной записи - приблизительный)
+	size_t size() const noexcept override {
+		return element_count.load(std::memory_order_relaxed);
+	}
+
+	//проверка на пустоту
+	bool empty() const noexcept override { return size() == 0; }
+
+	// Коэффициент заполнения
+	double load_factor() const override {
+		size_t buckets = max_bucket_count();
+		return buckets ? static_cast<double>(size()) / buckets : 0.0;
+	}
+
+	//максимальный коэффициент заполнения
+	double get_max_load_factor() const { return max_load_factor; }
+
+	//байт памяти: массивы ячеек (и ждущие освобождения) и узлы, включая удаленные
+	//до reclaim(); заголовки кучи и память ключей и значений не учитываются.
+	//Как и reclaim(), нельзя совмещать с конкурентными изменениями
+	size_t memory_usage() const {
+		size_t bytes = sizeof(*this);
+		for (const Array* a = first; a; a = a->next.load(std::memory_order_acquire)) {
+			bytes += sizeof(Array) + a->M * sizeof(std::atomic<Node*>);
+		}
+		size_t nodes = element_count.load(std::memory_order_relaxed);
+		for (const Node* node = retired_nodes.load(std::memory_order_acquire); node; node = node->retired) {
+			++nodes;
+		}
+		return bytes + nodes * sizeof(Node);
+	}
+
+	//---------- Обход -------------------//
+	// Позиция - массив и ячейка в нем; если перенос не закончен, обходятся все
+	// массивы цепочки (перенесенные ячейки помечены MOVED и пропускаются).
+	// Как и reclaim(), обход нельзя совмещать с конкурентными изменениями
+	Position first_position() const override {
+		return node_from(current.load(std::memory_order_acquire), 0);
+	}
+
+	Position next_position(Position at) const override {
+		return node_from(static_cast<const Array*>(at.node), at.slot + 1);
+	}
+
+	std::pair<const K*, const V*> entry_at(Position at) const override {
+		const Array* a = static_cast<const Array*>(at.node);
+		const Node* node = untag(a->slots[at.slot].load(std::memory_order_acquire));
+		return { &node->key, &node->value };
+	}
+
+private:
+	static constexpr double GROWTH_FACTOR = 1.618l;  //золотое сечение
+	static constexpr size_t MIGRATION_CHUNK = 1024;  //ячеек в порции переноса
+	static constexpr size_t CACHE_LINE = 64;
+	static constexpr uintptr_t FROZEN = 1;           //метка узла, который сейчас переносится
+
+	using Scheme = ProbeScheme<SizePolicy>;
+
+	struct alignas(8) Node { //ключ не меняется после публикации узла
+		template<typename KFwd, typename VFwd>
+		Node(KFwd&& k, VFwd&& v)
+			: key(std::forward<KFwd>(k)),
+			value(std::forward<VFwd>(v)) {
+		}
+
+		const K key;
+		V value;
+		Node* retired = nullptr; //следующий в списке удаленных узлов
+	};
+
+	struct Array { //массив ячеек одного размера и состояние его переноса
+		Array(size_t m, size_t a, size_t b, double mlf)
+			: M(m), scheme(m, a, b), limit(static_cast<size_t>(m * mlf)),
+			chunk_count((m + MIGRATION_CHUNK - 1) / MIGRATION_CHUNK),
+			slots(new std::atomic<Node*>[m]()) {
+		}
+
+		const size_t M;
+		const Scheme scheme;
+		const size_t limit;       //порог занятых ячеек
+		const size_t chunk_count; //порций переноса
+		const std::unique_ptr<std::atomic<Node*>[]> slots;
+
+		// счетчики на отдельных строках кэша: used меняют все вставки,
+		// остальные поля трогает только перенос
+		alignas(CACHE_LINE) std::atomic<size_t> used{ 0 };     //ячейки, бывшие занятыми (узлы и надгробия)
+		alignas(CACHE_LINE) std::atomic<Array*> next{ nullptr }; //массив, в который идет перенос
+		std::atomic<bool> resizing{ false }; //размер нового массива уже выбирается
+		std::atomic<size_t> claimed{ 0 };  //выданные порции
+		std::atomic<size_t> migrated{ 0 }; //завершенные порции
+	};
+
+	enum class Attempt { SUCCESS, FAILURE, RETRY }; //RETRY - массив перестраивается
+
+	//особые значения ячеек: узлы выровнены по 8, поэтому с ними не совпадают
+	static Node* tombstone() { return reinterpret_cast<Node*>(uintptr_t{ 2 }); }
+	static Node* moved() { return reinterpret_cast<Node*>(uintptr_t{ 4 }); }
+
+	static bool holds_node(Node* p) { return p != nullptr && p != tombstone() && p != moved(); }
+	static bool is_frozen(Node* p) { return reinterpret_cast<uintptr_t>(p) & FROZEN; }
+	static Node* freeze(Node* p) { return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(p) | FROZEN); }
+	static Node* untag(Node* p) { return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(p) & ~FROZEN); }
+
+	//первая ячейка с узлом начиная с ячейки index массива a
+	static Position node_from(const Array* a, size_t index) {
+		for (; a; a = a->next.load(std::memory_order_acquire), index = 0) {
+			for (; index < a->M; ++index) {
+				if (holds_node(a->slots[index].load(std::memory_order_acquire))) return { index, a };
+			}
+		}
+		return {};
+	}
+
+	void install(size_t M) {
+		first = new Array(M, A, B, max_load_factor);
+		current.store(first, std::memory_order_release);
+	}
+
+	//поиск узла с ключом. Ячейки MOVED пропускаются: если ключ еще здесь, он
+	//встретится раньше пустой ячейки; если цепочка задела перенесенные ячейки,
+	//ключ мог уехать - тогда ищем и в следующем массиве
+	Node* find_node(const K& key) const {
+		size_t hash = Hash{}(key);
+		for (const Array* a = current.load(std::memory_order_acquire); a; ) {
+			bool seen_moved = false;
+			ProbeSequence seq = a->scheme.start(hash);
+			for (size_t i = 0; i < a->M; ++i, seq.next()) {
+				Node* p = a->slots[seq.index()].load(std::memory_order_acquire);
+				if (p == nullptr) break;  // Дальше искать бессмысленно
+				if (p == moved()) {
+					seen_moved = true;
+					continue;
+				}
+				if (p == tombstone()) continue;
+				if (KeyEqual{}(untag(p)->key, key)) return untag(p);
+			}
+			if (!seen_moved) return nullptr;
+			a = a->next.load(std::memory_order_acquire);
+		}
+		return nullptr;
+	}
+
+	//вставка, если ключа нет; возвращает узел с ключом и признак вставки.
+	//make_node вызывается не больше одного раза и может забрать key
+	template<typename Make>
+	std::pair<Node*, bool> insert_node(const K& key, Make&& make_node) {
+		size_t hash = Hash{}(key);
+		Node* node = nullptr; //созданный, но еще не опубликованный узел
+		for (;;) {
+			Array* a = current.load(std::memory_order_acquire);
+			if (a->next.load(std::memory_order_acquire) == nullptr) {
+				Node* found = nullptr;
+				Attempt result = try_insert(a, hash, key, node, found, make_node);
+				if (result != Attempt::RETRY) {
+					if (result == Attempt::FAILURE) delete node;
+					return { found, result == Attempt::SUCCESS };
+				}
+			}
+			help_migrate(a);
+		}
+	}
+
+	//одна попытка вставки в массив a; found - узел с ключом (новый или уже бывший)
+	template<typename Make>
+	Attempt try_insert(Array* a, size_t hash, const K& key, Node*& node, Node*& found, Make& make_node) {
+		ProbeSequence seq = a->scheme.start(hash);
+		for (size_t i = 0; i < a->M; ++i, seq.next()) {
+			std::atomic<Node*>& slot = a->slots[seq.index()];
+			Node* p = slot.load(std::memory_order_acquire);
+			while (p == nullptr) {
+				if (!node) node = make_node();
+				// резервируем ячейку с учетом порога загрузки
+				if (a->used.fetch_add(1, std::memory_order_relaxed) >= a->limit) {
+					a->used.fetch_sub(1, std::memory_order_relaxed);
+					start_resize(a);
+					return Attempt::RETRY;
+				}
+				// узел попадет либо в подсчет start_resize, либо сюда придет resizing (оба - seq_cst)
+				element_count.fetch_add(1, std::memory_order_seq_cst);
+				if (a->resizing.load(std::memory_order_seq_cst)) {
+					a->used.fetch_sub(1, std::memory_order_relaxed);
+					element_count.fetch_sub(1, std::memory_order_relaxed);
+					std::this_thread::yield();
+					return Attempt::RETRY;
+				}
+				if (slot.compare_exchange_strong(p, node, std::memory_order_acq_rel, std::memory_order_acquire)) {
+					found = node;
+					return Attempt::SUCCESS;
+				}
+				// ячейку заняли раньше нас - смотрим, чем
+				a->used.fetch_sub(1, std::memory_order_relaxed);
+				element_count.fetch_sub(1, std::memory_order_relaxed);
+			}
+			if (p == moved()) return Attempt::RETRY;
+			if (p == tombstone()) continue;
+			// после make_node ключ мог переехать в узел
+			if (KeyEqual{}(untag(p)->key, node ? node->key : key)) {
+				found = untag(p);
+				return Attempt::FAILURE;
+			}
+		}
+		// при составном M цепочка может заполниться раньше порога загрузки
+		start_resize(a);
+		return Attempt::RETRY;
+	}
+
+	//одна попытка удаления из массива a
+	Attempt try_remove(Array* a, size_t hash, const K& key) {
+		ProbeSequence seq = a->scheme.start(hash);
+		for (size_t i = 0; i < a->M; ++i, seq.next()) {
+			std::atomic<Node*>& slot = a->slots[seq.index()];
+			Node* p = slot.load(std::memory_order_acquire);
+			if (p == nullptr) return Attempt::FAILURE;
+			if (p == moved()) return Attempt::RETRY;
+			if (p == tombstone() || !KeyEqual{}(untag(p)->key, key)) continue;
+			if (is_frozen(p)) return Attempt::RETRY;
+
+			if (slot.compare_exchange_strong(p, tombstone(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+				element_count.fetch_sub(1, std::memory_order_relaxed);
+				retire(p);
+				return Attempt::SUCCESS;
+			}
+			// узел уже удален другим потоком или переносится
+			return p == tombstone() ? Attempt::FAILURE : Attempt::RETRY;
+		}
+		return Attempt::FAILURE;
+	}
+
+	//создание нового массива для a, если перестроение еще никто не начал.
+	//Если место заняли в основном надгробия, размер не меняется; новый размер
+	//не меньше удвоенного числа живых узлов - перенос всегда находит свободную ячейку.
+	//Число узлов считается после установки resizing: вставки, не заставшие флаг,
+	//уже учтены в element_count, а заставшие - отказываются от ячейки
+	void start_resize(Array* a, size_t requested = 0) {
+		if (a->next.load(std::memory_order_acquire)) return;
+		if (a->resizing.exchange(true, std::memory_order_seq_cst)) {
+			std::this_thread::yield(); // размер выбирает другой поток
+			return;
+		}
+
+		size_t live = element_count.load(std::memory_order_seq_cst);
+		size_t target = requested;
+		if (target == 0) {
+			target = live < a->limit / 2 ? a->M : std::max(static_cast<size_t>(a->M * GROWTH_FACTOR), a->M + 1);
+		}
+		size_t new_M = Scheme::valid_grow_size(std::max(target, 2 * live + 1), A, B);
+
+		Array* fresh = nullptr;
+		try {
+			fresh = new Array(new_M, A, B, max_load_factor);
+		}
+		catch (...) {
+			a->resizing.store(false, std::memory_order_seq_cst);
+			throw;
+		}
+		a->next.store(fresh, std::memory_order_release);
+	}
+
+	//помощь в переносе массива a: разбираем свободные порции, ждем чужие
+	//и делаем новый массив текущим
+	void help_migrate(Array* a) {
+		Array* next = a->next.load(std::memory_order_acquire);
+		if (!next) return;
+
+		for (size_t chunk = a->claimed.fetch_add(1, std::memory_order_relaxed); chunk < a->chunk_count;
+			chunk = a->claimed.fetch_add(1, std::memory_order_relaxed)) {
+			size_t to = std::min((chunk + 1) * MIGRATION_CHUNK, a->M);
+			for (size_t i = chunk * MIGRATION_CHUNK; i < to; ++i) {
+				migrate_slot(a->slots[i], next);
+			}
+			a->migrated.fetch_add(1, std::memory_order_release);
+		}
+		while (a->migrated.load(std::memory_order_acquire) < a->chunk_count) {
+			std::this_thread::yield();
+		}
+		Array* expected = a;
+		current.compare_exchange_strong(expected, next, std::memory_order_acq_rel, std::memory_order_acquire);
+	}
+
+	//перенос одной ячейки: узел сначала замораживается (удалить нельзя,
+	//читать можно), затем размещается в новом массиве, и ячейка становится MOVED
+	void migrate_slot(std::atomic<Node*>& slot, Array* next) {
+		Node* p = slot.load(std::memory_order_acquire);
+		for (;;) {
+			Node* desired = holds_node(p) ? freeze(p) : moved();
+			if (slot.compare_exchange_weak(p, desired, std::memory_order_acq_rel, std::memory_order_acquire)) break;
+		}
+		if (!holds_node(p)) return;
+
+		place(next, p);
+		slot.store(moved(), std::memory_order_release);
+	}
+
+	//размещение узла в первой пустой ячейке его цепочки (ключа в массиве нет).
+	//Узлов меньше половины ячеек (см. start_resize), а квадратичная цепочка обходит
+	//не меньше половины ячеек - свободная найдется, перенос не бросает исключений
+	void place(Array* a, Node* node) noexcept {
+		for (ProbeSequence seq = a->scheme.start(Hash{}(node->key));; seq.next()) {
+			Node* expected = nullptr;
+			if (a->slots[seq.index()].compare_exchange_strong(expected, node,
+				std::memory_order_release, std::memory_order_relaxed)) {
+				a->used.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+		}
+	}
+
+	//удаленный узел откладывается до reclaim(): его еще могут читать
+	void retire(Node* node) {
+		Node* head = retired_nodes.load(std::memory_order_relaxed);
+		do {
+			node->retired = head;
+		} while (!retired_nodes.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	void free_retired_nodes() {
+		Node* node = retired_nodes.exchange(nullptr, std::memory_order_acquire);
+		while (node) {
+			delete std::exchange(node, node->retired);
+		}
+	}
+
+	//освобождение всей памяти; живые узлы есть только в текущем массиве
+	void destroy() {
+		Array* a = current.exchange(nullptr, std::memory_order_acquire);
+		if (!a) return;
+		for (size_t i = 0; i < a->M; ++i) {
+			Node* p = a->slots[i].load(std::memory_order_relaxed);
+			if (holds_node(p)) delete untag(p);
+		}
+		free_retired_nodes();
+		while (first) {
+			delete std::exchange(first, first->next.load(std::memory_order_relaxed));
+		}
+		element_count = 0;
+	}
+
+private:
+	//коэффициенты пробинга
+	size_t A; //линейный
+	size_t B; //квадратичный
+
+	double max_load_factor;
+
+	std::atomic<Array*> current{ nullptr };        //массив, в который идут вставки
+	Array* first = nullptr;                        //самый старый неосвобожденный массив (цепочка по next)
+	std::atomic<Node*> retired_nodes{ nullptr };   //удаленные узлы, ждущие освобождения
+
+	alignas(CACHE_LINE) std::atomic<size_t> element_count{ 0 }; //количество элементов
+};
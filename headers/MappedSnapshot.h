@@ -0,0 +1,180 @@
+﻿#pragma once
+#include "Snapshot.h"
+#include "OpenHashTable.h"
+#include <string>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Отображение снимка в память: OpenHashTable::map и OpenHashTable::Mapped.
+// Системные заголовки нужны только здесь, поэтому OpenHashTable.h их не включает:
+// кто вызывает map, включает этот заголовок
+
+// Файл, отображенный в память только для чтения
+class MappedFile {
+public:
+	MappedFile() = default;
+
+	explicit MappedFile(const std::string& path) {
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Snapshot: cannot open " + path);
+		LARGE_INTEGER length;
+		HANDLE mapping = nullptr;
+		if (GetFileSizeEx(file, &length) && length.QuadPart > 0) {
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		}
+		CloseHandle(file);
+		if (!mapping) throw std::runtime_error("Snapshot: cannot map " + path);
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (!view) throw std::runtime_error("Snapshot: cannot map " + path);
+		mapped = static_cast<const std::byte*>(view);
+		mapped_size = static_cast<size_t>(length.QuadPart);
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) throw std::runtime_error("Snapshot: cannot open " + path);
+		struct stat info;
+		void* view = MAP_FAILED;
+		if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+			view = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		::close(fd); // отображение остается действительным
+		if (view == MAP_FAILED) throw std::runtime_error("Snapshot: cannot map " + path);
+		mapped = static_cast<const std::byte*>(view);
+		mapped_size = static_cast<size_t>(info.st_size);
+#endif
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& other) noexcept
+		: mapped(std::exchange(other.mapped, nullptr)), mapped_size(std::exchange(other.mapped_size, 0)) {}
+
+	MappedFile& operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			unmap();
+			mapped = std::exchange(other.mapped, nullptr);
+			mapped_size = std::exchange(other.mapped_size, 0);
+		}
+		return *this;
+	}
+
+	~MappedFile() { unmap(); }
+
+	const std::byte* data() const noexcept { return mapped; }
+	size_t size() const noexcept { return mapped_size; }
+
+private:
+	void unmap() noexcept {
+		if (!mapped) return;
+#if defined(_WIN32)
+		UnmapViewOfFile(mapped);
+#else
+		::munmap(const_cast<std::byte*>(mapped), mapped_size);
+#endif
+		mapped = nullptr;
+		mapped_size = 0;
+	}
+
+	const std::byte* mapped = nullptr;
+	size_t mapped_size = 0;
+};
+
+// Таблица только для чтения поверх отображенного образа (см. map). Перемещается
+// без копирования страниц; отображение живет, пока жив объект
+template <typename K, typename V, typename SizePolicy, typename Hash, typename KeyEqual, typename Stats,
+	typename Allocator, typename Layout>
+	requires KeyHasher<Hash, K> && KeyEquality<KeyEqual, K> && StatsPolicy<Stats>
+class OpenHashTable<K, V, SizePolicy, Hash, KeyEqual, Stats, Allocator, Layout>::Mapped {
+public:
+	bool contains(const K& key) const { return find(key) != nullptr; }
+
+	const V* find(const K& key) const {
+		size_t index = find_slot(cells, scheme, key);
+		return index != NPOS ? &cells.value(index) : nullptr;
+	}
+
+	const V& at(const K& key) const {
+		const V* value = find(key);
+		if (!value) throw std::out_of_range("Key not found in hash table");
+		return *value;
+	}
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	bool contains(const Q& key) const { return find(key) != nullptr; }
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	const V* find(const Q& key) const {
+		size_t index = find_slot(cells, scheme, key);
+		return index != NPOS ? &cells.value(index) : nullptr;
+	}
+
+	size_t size() const noexcept { return count; }
+	bool empty() const noexcept { return count == 0; }
+	size_t max_bucket_count() const noexcept { return scheme.size(); }
+	double load_factor() const { return static_cast<double>(count) / scheme.size(); }
+
+private:
+	friend class OpenHashTable;
+
+	Mapped(MappedFile&& f, const SnapshotHeader& header, const std::array<size_t, Storage::ARRAYS + 1>& offsets)
+		: file(std::move(f)), scheme(header.buckets, header.a, header.b), count(header.size) {
+		const std::byte* arrays[Storage::ARRAYS];
+		for (size_t i = 0; i != Storage::ARRAYS; ++i) {
+			arrays[i] = file.data() + offsets[i];
+		}
+		cells = typename Storage::View(arrays);
+	}
+
+	MappedFile file;
+	typename Storage::View cells;
+	Scheme scheme;
+	size_t count;
+};
+
+template <typename K, typename V, typename SizePolicy, typename Hash, typename KeyEqual, typename Stats,
+	typename Allocator, typename Layout>
+	requires KeyHasher<Hash, K> && KeyEquality<KeyEqual, K> && StatsPolicy<Stats>
+auto OpenHashTable<K, V, SizePolicy, Hash, KeyEqual, Stats, Allocator, Layout>::map(const std::string& path, bool verify) -> Mapped
+	requires IMAGE_SNAPSHOT {
+	MappedFile file(path);
+	if (file.size() < sizeof(SnapshotHeader) + sizeof(uint64_t)) {
+		throw std::runtime_error("Snapshot: file too small");
+	}
+	SnapshotHeader header;
+	std::memcpy(&header, file.data(), sizeof(header));
+	check_header(header);
+	if (header.format != static_cast<uint32_t>(SnapshotFormat::IMAGE)) {
+		throw std::runtime_error("Snapshot: only image snapshots can be mapped");
+	}
+	auto offsets = image_offsets(header.buckets);
+	if (file.size() != offsets.back() + sizeof(uint64_t)) {
+		throw std::runtime_error("Snapshot: file size does not match the header");
+	}
+	if (verify) {
+		SnapshotChecksum checksum;
+		checksum.update(file.data(), offsets.back());
+		uint64_t stored;
+		std::memcpy(&stored, file.data() + offsets.back(), sizeof(stored));
+		if (stored != checksum.value()) throw std::runtime_error("Snapshot: checksum mismatch");
+	}
+	return Mapped(std::move(file), header, offsets);
+}
@@ -0,0 +1,182 @@
+﻿#pragma once
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <algorithm>
+
+// Пул узлов фиксированного размера: память выделяется блоками (slab),
+// освобожденные узлы складываются в список свободных и переиспользуются.
+// Вставка в таблицу не обращается к malloc, пока в пуле есть место,
+// и на узел не тратится заголовок кучи. Блоки выделяются через Allocator
+template <typename T, typename Allocator = std::allocator<T>>
+class NodePool {
+
+public:
+	//----------- Конструкторы -------------------//
+	NodePool() = default;
+
+	// Копирование пула не имеет смысла: владелец сам копирует узлы
+	NodePool(const NodePool&) = delete;
+	NodePool& operator=(const NodePool&) = delete;
+
+	NodePool(NodePool&& other) noexcept
+		: slot_alloc(other.slot_alloc),
+		slabs(std::move(other.slabs)),
+		free_list(std::exchange(other.free_list, nullptr)),
+		next_slot(std::exchange(other.next_slot, 0)),
+		slab_capacity(std::exchange(other.slab_capacity, 0))
+	{}
+
+	NodePool& operator=(NodePool&& other) noexcept {
+		if (this != &other) {
+			release_slabs();
+			slot_alloc = other.slot_alloc;
+			slabs = std::move(other.slabs);
+			free_list = std::exchange(other.free_list, nullptr);
+			next_slot = std::exchange(other.next_slot, 0);
+			slab_capacity = std::exchange(other.slab_capacity, 0);
+		}
+		return *this;
+	}
+
+	~NodePool() { release_slabs(); }
+
+	//---------- Основные операции-------------------//
+	// Создание узла (объекты, оставшиеся в пуле, владелец обязан уничтожить сам)
+	template <typename... Args>
+	T* create(Args&&... args) {
+		Slot* slot = allocate_slot();
+		try {
+			return ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			release_slot(slot);
+			throw;
+		}
+	}
+
+	// Уничтожение узла и возврат памяти в список свободных
+	void destroy(T* node) noexcept {
+		node->~T();
+		release_slot(reinterpret_cast<Slot*>(node));
+	}
+
+	// Заранее выделить место не меньше чем под count новых узлов
+	void reserve(size_t count) {
+		size_t available = slab_capacity - next_slot;
+		for (Slot* s = free_list; s && available < count; s = s->next_free) {
+			++available;
+		}
+		if (available < count) {
+			add_slab(count - available);
+		}
+	}
+
+	// Место в списке блоков еще под count блоков: merge пула, у которого их не больше,
+	// после этого не бросает исключений
+	void reserve_slabs(size_t count) {
+		if (slabs.capacity() - slabs.size() < count) {
+			slabs.reserve(std::max(2 * slabs.size() + 1, slabs.size() + count));
+		}
+	}
+
+	// Присоединение блоков other вместе с созданными в них узлами (уничтожает их
+	// теперь этот пул), свободные места other переходят в список свободных.
+	// Так узлы, созданные в отдельных пулах разными потоками, собираются в один
+	void merge(NodePool&& other) {
+		reserve_slabs(other.slabs.size());
+		retire_tail();
+		other.retire_tail();
+		if (Slot* last = other.free_list) {
+			while (last->next_free) last = last->next_free;
+			last->next_free = free_list;
+			free_list = std::exchange(other.free_list, nullptr);
+		}
+		slabs.insert(slabs.end(), other.slabs.begin(), other.slabs.end());
+		other.slabs.clear();
+		other.next_slot = 0;
+		other.slab_capacity = 0;
+	}
+
+	// Байт памяти, занятой блоками и их списком
+	size_t memory_usage() const noexcept {
+		size_t bytes = slabs.capacity() * sizeof(Slab);
+		for (const Slab& slab : slabs) {
+			bytes += slab.count * sizeof(Slot);
+		}
+		return bytes;
+	}
+
+private:
+	static constexpr size_t MIN_SLAB = 64;          //узлов в первом блоке
+	static constexpr size_t MAX_SLAB = 64 * 1024;   //предел геометрического роста блоков
+
+	union Slot {
+		Slot* next_free;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	struct Slab {
+		Slot* first;
+		size_t count;
+	};
+
+	using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+	using SlabAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slab>;
+
+	Slot* allocate_slot() {
+		if (free_list) {
+			return std::exchange(free_list, free_list->next_free);
+		}
+		if (next_slot == slab_capacity) {
+			add_slab(0);
+		}
+		return &slabs.back().first[next_slot++];
+	}
+
+	void release_slot(Slot* slot) noexcept {
+		slot->next_free = free_list;
+		free_list = slot;
+	}
+
+	// Новый блок: размер растет вдвое, но не меньше запрошенного
+	void add_slab(size_t at_least) {
+		retire_tail();
+		size_t count = slabs.empty() ? MIN_SLAB : slabs.back().count * 2;
+		if (count > MAX_SLAB) count = MAX_SLAB;
+		if (count < at_least) count = at_least;
+
+		// место в списке - заранее, чтобы push_back не бросил после выделения блока
+		reserve_slabs(1);
+		Slot* first = std::allocator_traits<SlotAllocator>::allocate(slot_alloc, count);
+		slabs.push_back({ first, count });
+		next_slot = 0;
+		slab_capacity = count;
+	}
+
+	// Остаток последнего блока уходит в список свободных
+	void retire_tail() noexcept {
+		for (; next_slot < slab_capacity; ++next_slot) {
+			release_slot(&slabs.back().first[next_slot]);
+		}
+	}
+
+	// Возврат блоков аллокатору (узлы к этому моменту уничтожены владельцем)
+	void release_slabs() noexcept {
+		for (const Slab& slab : slabs) {
+			std::allocator_traits<SlotAllocator>::deallocate(slot_alloc, slab.first, slab.count);
+		}
+		slabs.clear();
+		free_list = nullptr;
+		next_slot = 0;
+		slab_capacity = 0;
+	}
+
+private:
+	[[no_unique_address]] SlotAllocator slot_alloc;
+	std::vector<Slab, SlabAllocator> slabs; //блоки и их размеры
+	Slot* free_list = nullptr;   //освобожденные узлы
+	size_t next_slot = 0;        //первый нетронутый слот последнего блока
+	size_t slab_capacity = 0;    //размер последнего блока
+};
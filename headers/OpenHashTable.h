@@ -4,24 +4,55 @@
 #include <vector>
 #include <stdexcept>
 #include <numeric>
+#include <algorithm>
+#include <utility>
+#include <memory>
+#include "SizePolicy.h"
+#include "BatchLookup.h"
+#include "TableStats.h"
+#include "EntryLayout.h"
+#include "BulkLoad.h"
+#include "FrozenHashTable.h"
+#include "Snapshot.h" // отображение в память (map) - в MappedSnapshot.h
+#include <array>
+#include <fstream>
+#include <limits>
+#include <cstring>
 
-template <typename K, typename V> requires HashableKey<K>
-class OpenHashTable : public IHashTable<K, V> {
+// Режим рехэширования при достижении max load factor
+enum class RehashMode {
+	STOP_THE_WORLD, // все элементы переносятся за один вызов
+	INCREMENTAL     // старая и новая таблицы живут вместе, перенос порциями
+};
+
+template <typename K, typename V, typename SizePolicy = ModuloSizePolicy,
+	typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>, typename Stats = NoStats,
+	typename Allocator = std::allocator<std::pair<const K, V>>, typename Layout = InterleavedLayout>
+	requires KeyHasher<Hash, K> && KeyEquality<KeyEqual, K> && StatsPolicy<Stats>
+class OpenHashTable final : public IHashTable<K, V> {
 
 public:
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using allocator_type = Allocator;
+	using layout_type = Layout;
+	using typename IHashTable<K, V>::Position;
+
 	//----------- Конструкторы -------------------//
 	OpenHashTable() = delete;
-	
-	explicit OpenHashTable(size_t size, size_t a = 0, size_t b = 1, double mlf = 0.75l)
-		: table(size), M(size), A(a), B(b), max_load_factor(mlf){
-		
-		if (M == 0) throw std::invalid_argument("Size must be positive");
+
+	explicit OpenHashTable(size_t size, size_t a = 0, size_t b = 1, double mlf = 0.75l,
+		RehashMode mode = RehashMode::STOP_THE_WORLD)
+		: table(SizePolicy::round_size(size)), M(table.size()), A(a), B(b), max_load_factor(mlf),
+		rehash_mode(mode) {
+
+		if (size == 0) throw std::invalid_argument("Size must be positive");
 
 		// Хотя бы один коэффициент должен быть ненулевым
 		if (A == 0 && B == 0) {
 			throw std::invalid_argument("At least one of A or B must be non-zero");
 		}
-		
+
 		// Проверяем только ненулевые коэффициенты
 		if (A != 0 && std::gcd(A, M) != 1) {
 			throw std::invalid_argument("A must be coprime with M or zero");
@@ -29,17 +60,26 @@ public:
 		if (B != 0 && std::gcd(B, M) != 1) {
 			throw std::invalid_argument("B must be coprime with M or zero");
 		}
+		scheme = Scheme(M, A, B);
 	}
 
 	OpenHashTable(const OpenHashTable&) = default;
-	
+
 	OpenHashTable(OpenHashTable&& other) noexcept
 		: table(std::move(other.table)),
 		M(std::exchange(other.M, 0)),
 		A(std::exchange(other.A, 0)),
 		B(std::exchange(other.B, 0)),
 		max_load_factor(std::move(other.max_load_factor)),
-		element_count(std::exchange(other.element_count, 0))
+		rehash_mode(other.rehash_mode),
+		scheme(other.scheme),
+		element_count(std::exchange(other.element_count, 0)),
+		deleted_count(std::exchange(other.deleted_count, 0)),
+		old_table(std::move(other.old_table)),
+		old_M(std::exchange(other.old_M, 0)),
+		old_scheme(other.old_scheme),
+		migrate_pos(std::exchange(other.migrate_pos, 0)),
+		counters(other.counters)
 	{}
 	OpenHashTable& operator=(const OpenHashTable&) = default;
 
@@ -50,7 +90,15 @@ public:
 			A = std::exchange(other.A, 0);
 			B = std::exchange(other.B, 0);
 			max_load_factor = other.max_load_factor;
+			rehash_mode = other.rehash_mode;
+			scheme = other.scheme;
 			element_count = std::exchange(other.element_count, 0);
+			deleted_count = std::exchange(other.deleted_count, 0);
+			old_table = std::move(other.old_table);
+			old_M = std::exchange(other.old_M, 0);
+			old_scheme = other.old_scheme;
+			migrate_pos = std::exchange(other.migrate_pos, 0);
+			counters = other.counters;
 		}
 		return *this;
 	}
@@ -59,197 +107,174 @@ public:
 	//---------- Основные операции-------------------//
 	//Операции вставки
 	bool insert(K key, const V& value) override {
-		
-		constexpr double GROWTH_FACTOR = 1.618l;  //золотое сечение
-		
+
 		// Гарантируем, что место есть
-		if (load_factor() >= max_load_factor) {
-			rehash(M * GROWTH_FACTOR);
-		}
+		prepare_insert();
 		// Собственно вставка
 		return insert_impl(std::move(key), value);
 	}
-		
+
 	bool insert(K key, V&& value) override {
 
-		constexpr double GROWTH_FACTOR = 1.618l;  //золотое сечение
-		
-		if (load_factor() >= max_load_factor) {
-			rehash(static_cast<size_t>(M * GROWTH_FACTOR));
-		}
+		prepare_insert();
 		return insert_impl(std::move(key), std::move(value));
 	}
 
+	bool insert_or_assign(K key, const V& value) override {
+		prepare_insert();
+		return assign_impl(std::move(key), value);
+	}
+
+	bool insert_or_assign(K key, V&& value) override {
+		prepare_insert();
+		return assign_impl(std::move(key), std::move(value));
+	}
+
+	//вставка со значением, построенным из args; если ключ уже есть,
+	//значение не создается и args не трогаются. Возвращает {значение, вставлено ли}
+	template<typename... Args> requires std::constructible_from<V, Args...>
+	std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+		prepare_insert();
+		return emplace_impl(key, std::forward<Args>(args)...);
+	}
+
+	template<typename... Args> requires std::constructible_from<V, Args...>
+	std::pair<V*, bool> try_emplace(K&& key, Args&&... args) {
+		prepare_insert();
+		return emplace_impl(std::move(key), std::forward<Args>(args)...);
+	}
+
+	//то же, но ключ строится из любого подходящего аргумента (один раз, до поиска)
+	template<typename KArg, typename... Args>
+		requires std::constructible_from<K, KArg> && std::constructible_from<V, Args...>
+	std::pair<V*, bool> emplace(KArg&& key, Args&&... args) {
+		return try_emplace(K(std::forward<KArg>(key)), std::forward<Args>(args)...);
+	}
+
 	//операции удаления
 	bool remove(const K& key) override {
-		
-		size_t base_hash = std::hash<K>{}(key) % M;
-		for (size_t i = 0; i < M; ++i) {
-			auto& entry = table[probe(base_hash, i)];
-			if (entry.is_active() && entry.key == key) {
-				entry.state = EntryState::DELETED;
-				--element_count;
-				return true;
-			}
-			if (entry.is_empty()) {
-				return false;
-			}
-		}		
-		return false;
+		return remove_impl(key);
 	}
 
 	//операции доступа и поиска
 	bool contains(const K& key) const override {
-		size_t base_hash = std::hash<K>{}(key) % M;
-		for (size_t i = 0; i < M; ++i) {
-			const auto& entry = table[probe(base_hash, i)];
-			if (entry.is_active() && entry.key == key) {
-				return true;
-			}
-			if (entry.is_empty()) {
-				return false;  // Дальше искать бессмысленно
-			}			
-		}
-		return false;
+		return find_value(key) != nullptr;
 	}
 
 	V* find(const K& key) override {
-		size_t base_hash = std::hash<K>{}(key) % M;
-		for (size_t i = 0; i < M; ++i) {
-			auto& entry = table[probe(base_hash, i)];
-			if (entry.is_active() && entry.key == key) {
-				return &entry.value;
-			}
-			if (entry.is_empty()) {
-				return nullptr;  // Дальше искать бессмысленно
-			}
-			// DELETED — продолжаем
-		}
-		return nullptr;
+		return find_value(key);
 	}
 
 	const V* find(const K& key) const override {
-		size_t base_hash = std::hash<K>{}(key) % M;
-		for (size_t i = 0; i < M; ++i) {
-			const auto& entry = table[probe(base_hash, i)];
-			if (entry.is_active() && entry.key == key) {
-				return &entry.value;
-			}
-			if (entry.is_empty()) {
-				return nullptr;
-			}
-		}
-		return nullptr;
+		return find_value(key);
 	}
 
 	V& at(const K& key) override {
-		
-		size_t base_hash = std::hash<K>{}(key) % M;
-		for (size_t i = 0; i < M; ++i) {
-			auto& entry = table[probe(base_hash, i)];
-			if (entry.is_active() && entry.key == key) {
-				return entry.value;
-			}
-			if (entry.is_empty()) {
-				throw std::out_of_range("Key not found in hash table");
-			}
-			
-		}
-		throw std::out_of_range("Key not found in hash table");		
+		V* value = find_value(key);
+		if (!value) throw std::out_of_range("Key not found in hash table");
+		return *value;
 	};
 
-	const V& at(const K& key) const override {//заглушка
-		size_t base_hash = std::hash<K>{}(key) % M;
-		for (size_t i = 0; i < M; ++i) {
-			const auto& entry = table[probe(base_hash, i)];
-			if (entry.is_active() && entry.key == key) {
-				return entry.value;
-			}
-			if (entry.is_empty()) {
-				throw std::out_of_range("Key not found in hash table");
-			}
-		}	
-		throw std::out_of_range("Key not found in hash table");		
+	const V& at(const K& key) const override {
+		const V* value = find_value(key);
+		if (!value) throw std::out_of_range("Key not found in hash table");
+		return *value;
 	}
 
 	// Только для неконстантных объектов
 	V& operator[](const K& key) override {
-		
-		size_t base_hash = std::hash<K>{}(key) % M;		
-		int first_deleted = -1;		
 
-		for (size_t i = 0; i < M; ++i) {
-			size_t index = probe(base_hash, i);
-			Entry& entry = table[index];
+		migrate_step();
+		if (V* value = find_value(key)) return *value;
 
-			if (entry.is_active()) {
-				if (entry.key == key) return entry.value;
-			}
-			else if (entry.is_deleted()) {
-				if (first_deleted == -1) first_deleted = index;
-			}
-			else { // EMPTY				
-				entry = Entry(key, V{});
-				++element_count;
-				return entry.value;
-			}
-		}
-		
-		if (first_deleted != -1) {
-			table[first_deleted] = Entry(key, V{});
-			++element_count;
-			return table[first_deleted].value;
-		}
-		
-		throw std::runtime_error("Hash table invariant violated");
+		if (needs_space()) make_space();
+
+		return *emplace_impl(key).first;
 	}
 
 	//очистка
 	void clear() override {
-		
-		std::vector<Entry> new_table(M);
-		element_count = 0; 
-		table = new_table;
+
+		element_count = 0;
+		deleted_count = 0;
+		table = Storage(M);
+		release_old_table();
 	}
 
 	//---------- Рехэширование -------------------//
 	void rehash(size_t new_M) override {
+		rehash(new_M, 0);
+	}
+
+	// То же в threads потоках; 0 - автоматически: по числу ядер, но не больше
+	// одного потока на BULK_MIN_ITEMS элементов (у небольшой таблицы - в одном)
+	void rehash(size_t new_M, size_t threads) {
 		if (new_M < M) {
 			throw std::invalid_argument("rehash: new size too small");
 		}
+		[[maybe_unused]] auto timer = counters.rehash_timer();
+		// незавершенный инкрементальный перенос доводим до конца
+		finish_migration();
+		// ближайший допустимый размер, взаимно простой с A и B
+		new_M = Scheme::valid_size(new_M, A, B);
 		if (new_M == M) return;
+		counters.on_rehash();
 
-		// Проверяем только ненулевые коэффициенты
-		if (A != 0 && std::gcd(A, new_M) != 1) {
-			throw std::invalid_argument("new table size must be coprime with A");
+		Scheme new_scheme(new_M, A, B);
+		Storage rehash_table(new_M);
+		size_t parts = bulk_threads(element_count, std::min(M, new_M), threads);
+		if (parts > 1) {
+			move_entries_parallel(table, rehash_table, new_scheme, parts);
+		}
+		else {
+			move_entries(table, rehash_table, new_scheme, 0, table.size());
 		}
-		if (B != 0 && std::gcd(B, M) != 1) {
-			throw std::invalid_argument("new table size must be coprime with B");
-		}		
-
-		std::vector<Entry> rehash_table(new_M);
-		size_t new_count = 0;
-
-		for (auto& old : table) {  // берем по ссылке, чтобы перемещать
-			if (!old.is_active()) continue;  // только активные
 
-			size_t hash = std::hash<K>{}(old.key) % new_M;
+		table = std::move(rehash_table);
+		M = new_M;
+		scheme = new_scheme;
+		deleted_count = 0;
+	}
 
-			for (size_t i = 0; i < new_M; ++i) {  // ищем по всей новой таблице
-				size_t index = probe(hash, i, new_M);
-				Entry& entry = rehash_table[index];
+	// Очистка надгробий без изменения размера, на месте:
+	// каждый элемент переставляется на первую ячейку своей цепочки пробинга,
+	// не занятую уже размещенными элементами
+	void compact() {
+		[[maybe_unused]] auto timer = counters.rehash_timer();
+		counters.on_rehash();
+		finish_migration();
 
-				if (entry.is_empty()) {
-					entry = std::move(old);  // перемещаем старую запись
-					++new_count;
-					break;
+		// DELETED -> EMPTY, ACTIVE -> DELETED (элемент ждет размещения)
+		for (size_t i = 0; i < M; ++i) {
+			table.set_state(i, table.is_active(i) ? EntryState::DELETED : EntryState::EMPTY);
+		}
+		for (size_t i = 0; i < M; ++i) {
+			while (table.is_deleted(i)) {
+				size_t target = free_slot(table, scheme, Hash{}(table.key(i)));
+				if (target == i) {
+					table.set_state(i, EntryState::ACTIVE);
+				}
+				else if (table.is_empty(target)) {
+					table.key(target) = std::move(table.key(i));
+					table.value(target) = std::move(table.value(i));
+					table.set_state(target, EntryState::ACTIVE);
+					table.set_state(i, EntryState::EMPTY);
+				}
+				else { // там ждет другой элемент - меняемся и размещаем его следующим
+					std::swap(table.key(i), table.key(target));
+					std::swap(table.value(i), table.value(target));
+					table.set_state(target, EntryState::ACTIVE);
 				}
 			}
 		}
+		deleted_count = 0;
+	}
 
-		element_count = new_count;
-		table = std::move(rehash_table);
-		M = new_M;
+	// Завершить начатое инкрементальное рехэширование
+	void finish_migration() {
+		while (migrating()) {
+			migrate_step();
+		}
 	}
 
 	//---------- Характeристики-------------------//
@@ -258,7 +283,7 @@ public:
 	[[nodiscard]] size_t max_bucket_count() const noexcept override { return M; }
 
 	//фактический размер
-	size_t size() const noexcept {				
+	size_t size() const noexcept {
 		return element_count;
 	}
 
@@ -273,83 +298,772 @@ public:
 	//максимальный коэффициент заполнения
 	double get_max_load_factor() const { return max_load_factor; }
 
+	//число надгробий (DELETED) в текущей таблице
+	size_t tombstone_count() const noexcept { return deleted_count; }
+
+	//режим рехэширования
+	RehashMode get_rehash_mode() const { return rehash_mode; }
+
+	//идет ли инкрементальный перенос из старой таблицы
+	bool migrating() const noexcept { return old_M != 0; }
+
+	//среднее число проб до найденного ключа (по записям текущей таблицы):
+	//1 - каждый ключ лежит в своей домашней ячейке
+	double average_probe_length() const {
+		return stats().average_chain_length;
+	}
+
+	//сводка: пустые ячейки, надгробия и длины пробинга до ключей текущей таблицы;
+	//гистограммы и счетчики - при Stats = CountingStats
+	TableStats stats() const {
+		TableStats result;
+		result.size = element_count;
+		result.buckets = M;
+		result.load_factor = load_factor();
+		result.tombstones = deleted_count;
+		size_t active = 0;
+		size_t probes = 0;
+		for (size_t index = 0; index < M; ++index) {
+			if (table.is_empty(index)) ++result.empty_buckets;
+			if (!table.is_active(index)) continue;
+			ProbeSequence seq = scheme.start(Hash{}(table.key(index)));
+			size_t length = 1;
+			for (; seq.index() != index; seq.next()) ++length;
+			result.max_chain_length = std::max(result.max_chain_length, length);
+			probes += length;
+			++active;
+		}
+		result.empty_bucket_ratio = static_cast<double>(result.empty_buckets) / M;
+		result.average_chain_length = active ? static_cast<double>(probes) / active : 0.0;
+		counters.report(result);
+		return result;
+	}
+
+	//обнуление счетчиков статистики
+	void reset_stats() { counters.reset(); }
+
+	//байт памяти таблицы: сам объект и массивы ячеек (во время переноса - обе таблицы).
+	//Память, которой владеют ключи и значения, например буферы строк, не учитывается
+	size_t memory_usage() const noexcept {
+		return sizeof(*this) + table.memory_usage() + old_table.memory_usage();
+	}
+
+	//---------- Обход -------------------//
+	// Позиция - ячейка текущей таблицы, во время переноса за ними идут ячейки старой
+	Position first_position() const override { return active_from(0); }
+
+	Position next_position(Position at) const override { return active_from(at.slot + 1); }
+
+	std::pair<const K*, const V*> entry_at(Position at) const override {
+		const Storage& t = at.slot < M ? table : old_table;
+		size_t index = at.slot < M ? at.slot : at.slot - M;
+		return { &t.key(index), &t.value(index) };
+	}
+
+	//---------- Поиск по ключу другого типа -------------------//
+	// Доступен при прозрачных Hash и KeyEqual: например, std::string-ключ
+	// ищется по std::string_view или const char* без временной строки
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	bool remove(const Q& key) { return remove_impl(key); }
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	bool contains(const Q& key) const { return find_value(key) != nullptr; }
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	V* find(const Q& key) { return find_value(key); }
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	const V* find(const Q& key) const { return find_value(key); }
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	V& at(const Q& key) {
+		V* value = find_value(key);
+		if (!value) throw std::out_of_range("Key not found in hash table");
+		return *value;
+	}
+
+	template<typename Q> requires TransparentLookup<Hash, KeyEqual, K, Q>
+	const V& at(const Q& key) const {
+		const V* value = find_value(key);
+		if (!value) throw std::out_of_range("Key not found in hash table");
+		return *value;
+	}
+
+	//---------- Пакетные операции -------------------//
+	// Во время инкрементального переноса ключ может быть в любой из двух таблиц -
+	// тогда ключи ищутся по одному
+	void find_batch(std::span<const K> keys, std::span<V*> results) override {
+		if (migrating()) return IHashTable<K, V>::find_batch(keys, results);
+		this->check_batch(keys.size(), results.size());
+		lookup_batch(keys, [&](size_t i, const V* value) { results[i] = const_cast<V*>(value); });
+	}
+
+	void find_batch(std::span<const K> keys, std::span<const V*> results) const override {
+		if (migrating()) return IHashTable<K, V>::find_batch(keys, results);
+		this->check_batch(keys.size(), results.size());
+		lookup_batch(keys, [&](size_t i, const V* value) { results[i] = value; });
+	}
+
+	size_t contains_batch(std::span<const K> keys, std::span<bool> results) const override {
+		if (migrating()) return IHashTable<K, V>::contains_batch(keys, results);
+		this->check_batch(keys.size(), results.size());
+		size_t found = 0;
+		lookup_batch(keys, [&](size_t i, const V* value) {
+			results[i] = value != nullptr;
+			found += results[i];
+		});
+		return found;
+	}
+
+	//домашние ячейки блока предвыбираются до вставок
+	size_t insert_batch(std::span<const std::pair<K, V>> items) override {
+		size_t inserted = 0;
+		for (size_t begin = 0; begin < items.size(); begin += BATCH_BLOCK) {
+			size_t end = std::min(begin + BATCH_BLOCK, items.size());
+			for (size_t i = begin; i < end; ++i) {
+				table.prefetch(scheme.home(Hash{}(items[i].first)));
+			}
+			for (size_t i = begin; i < end; ++i) {
+				prepare_insert();
+				inserted += insert_impl(items[i].first, items[i].second);
+			}
+		}
+		return inserted;
+	}
+
+	//---------- Заморозка -------------------//
+	// Неизменяемая копия с минимальным совершенным хешированием (FrozenHashTable.h):
+	// каждый поиск - одна ячейка и одно сравнение. Таблица остается как была
+	FrozenHashTable<K, V, Hash, KeyEqual> freeze() const {
+		std::vector<std::pair<K, V>> items;
+		items.reserve(size());
+		for (Position at = first_position(); at != Position{}; at = next_position(at)) {
+			auto [key, value] = entry_at(at);
+			items.emplace_back(*key, *value);
+		}
+		return FrozenHashTable<K, V, Hash, KeyEqual>(std::move(items));
+	}
+
+	//---------- Параллельная загрузка -------------------//
+	// Вставка items в threads потоках (0 - по числу ядер) с тем же результатом, что
+	// insert каждого элемента по порядку: из повторяющихся ключей вставляется первый,
+	// значения уже имеющихся ключей не меняются. Таблица заранее растет под все элементы,
+	// каждый поток заполняет свой диапазон ячеек; ключи, чей пробинг выходит за диапазон,
+	// вставляются затем по одному. Возвращает число вставленных
+	size_t insert_bulk(std::span<const std::pair<K, V>> items, size_t threads = 0) {
+		finish_migration();
+		const size_t count = items.size();
+		if (static_cast<double>(element_count + deleted_count + count) / M >= max_load_factor) {
+			size_t needed = static_cast<size_t>((element_count + count) / max_load_factor) + 1;
+			rehash(Scheme::valid_grow_size(std::max(needed, M), A, B));
+		}
+
+		const size_t parts = bulk_threads(count, M, threads);
+		std::vector<size_t> hashes(count);
+		run_parallel(parts, [&](size_t part) {
+			for (size_t i = bulk_bound(count, parts, part); i != bulk_bound(count, parts, part + 1); ++i) {
+				hashes[i] = Hash{}(items[i].first);
+			}
+		});
+		BulkPartition partition = partition_by_slot(count, M, parts, [&](size_t i) { return scheme.home(hashes[i]); });
+
+		std::vector<std::vector<size_t>> deferred(parts);
+		std::vector<size_t> inserted(parts, 0);
+		std::vector<size_t> reused(parts, 0); //занятые надгробия
+		auto collect = [&]() {
+			size_t total = 0;
+			for (size_t part = 0; part != parts; ++part) {
+				total += inserted[part];
+				deleted_count -= reused[part];
+			}
+			element_count += total;
+			for (size_t i = 0; i != total; ++i) counters.on_insert();
+			return total;
+		};
+		try {
+			run_parallel(parts, [&](size_t part) {
+				size_t from = bulk_bound(M, parts, part);
+				size_t to = bulk_bound(M, parts, part + 1);
+				for (size_t k = partition.bounds[part]; k != partition.bounds[part + 1]; ++k) {
+					size_t i = partition.order[k];
+					switch (place_in_range(items[i], hashes[i], from, to, reused[part])) {
+					case BulkPlacement::INSERTED: ++inserted[part]; break;
+					case BulkPlacement::DEFERRED: deferred[part].push_back(i); break;
+					case BulkPlacement::PRESENT: break;
+					}
+				}
+			});
+		}
+		catch (...) {
+			collect();
+			throw;
+		}
+		size_t total = collect();
+
+		// отложенные - в исходном порядке, чтобы из повторов снова победил первый
+		std::vector<size_t> rest;
+		for (const std::vector<size_t>& part : deferred) {
+			rest.insert(rest.end(), part.begin(), part.end());
+		}
+		std::sort(rest.begin(), rest.end());
+		for (size_t i : rest) {
+			prepare_insert();
+			total += insert_impl(items[i].first, items[i].second);
+		}
+		return total;
+	}
+
+	//---------- Снимки -------------------//
+	// Снимок (Snapshot.h): для тривиально копируемых K и V - образ массивов ячеек (IMAGE),
+	// который load читает целиком, а map отображает в память без разбора; для остальных
+	// типов - пары ключ-значение через SnapshotCodec (STREAM). Сохраняются M, A, B,
+	// max load factor, число элементов и надгробий; счетчики статистики - нет.
+	// Хеш-функция и политика размера в снимок не пишутся: читать его нужно тем же типом таблицы
+	static constexpr bool IMAGE_SNAPSHOT = std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>;
+
+	void save(std::ostream& out) const requires SnapshotStreamable<K> && SnapshotStreamable<V> {
+		if (migrating()) { // образ - только одна таблица
+			OpenHashTable copy(*this);
+			copy.finish_migration();
+			copy.save(out);
+			return;
+		}
+		SnapshotHeader header{};
+		std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+		header.version = SNAPSHOT_VERSION;
+		header.byte_order = SNAPSHOT_BYTE_ORDER;
+		header.format = static_cast<uint32_t>(IMAGE_SNAPSHOT ? SnapshotFormat::IMAGE : SnapshotFormat::STREAM);
+		header.layout = Layout::ID;
+		header.key_size = sizeof(K);
+		header.key_align = alignof(K);
+		header.value_size = sizeof(V);
+		header.value_align = alignof(V);
+		header.buckets = M;
+		header.a = A;
+		header.b = B;
+		header.size = element_count;
+		header.tombstones = deleted_count;
+		header.max_load_factor = max_load_factor;
+
+		SnapshotWriter writer(out);
+		if constexpr (IMAGE_SNAPSHOT) {
+			header.data_bytes = image_offsets(M).back() - sizeof(SnapshotHeader);
+			writer.write_value(header);
+			size_t current = NPOS; //массив, который сейчас пишется
+			table.for_each_image_piece([&](size_t array, const void* data, size_t bytes) {
+				if (array != current) writer.pad(SNAPSHOT_ALIGN);
+				current = array;
+				writer.write(data, bytes);
+			});
+		}
+		else {
+			writer.write_value(header); // data_bytes = 0: длина записей заранее неизвестна
+			for (size_t i = 0; i < M; ++i) {
+				if (!table.is_active(i)) continue;
+				SnapshotCodec<K>::write(writer, table.key(i));
+				SnapshotCodec<V>::write(writer, table.value(i));
+			}
+		}
+		writer.finish();
+	}
+
+	void save(const std::string& path) const requires SnapshotStreamable<K> && SnapshotStreamable<V> {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) throw std::runtime_error("Snapshot: cannot create " + path);
+		save(file);
+		file.flush();
+		if (!file) throw std::runtime_error("Snapshot: write failed");
+	}
+
+	// Таблица из снимка любого формата (образ - только для тривиально копируемых K и V);
+	// при повреждении или несовпадении типов - std::runtime_error
+	static OpenHashTable load(std::istream& in) requires SnapshotStreamable<K> && SnapshotStreamable<V> {
+		SnapshotReader reader(in);
+		SnapshotHeader header = reader.read_value<SnapshotHeader>();
+		check_header(header);
+		OpenHashTable result(header.buckets, header.a, header.b, header.max_load_factor);
+
+		if (header.format == static_cast<uint32_t>(SnapshotFormat::IMAGE)) {
+			if constexpr (IMAGE_SNAPSHOT) {
+				result.table.for_each_array([&](void* data, size_t bytes) {
+					reader.skip_padding(SNAPSHOT_ALIGN);
+					reader.read(data, bytes);
+				});
+				result.element_count = header.size;
+				result.deleted_count = header.tombstones;
+			}
+		}
+		else {
+			for (uint64_t i = 0; i != header.size; ++i) {
+				K key = SnapshotCodec<K>::read(reader);
+				V value = SnapshotCodec<V>::read(reader);
+				result.prepare_insert();
+				result.insert_impl(std::move(key), std::move(value));
+			}
+		}
+		reader.finish();
+		return result;
+	}
+
+	static OpenHashTable load(const std::string& path) requires SnapshotStreamable<K> && SnapshotStreamable<V> {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) throw std::runtime_error("Snapshot: cannot open " + path);
+		return load(file);
+	}
+
+	class Mapped;
+
+	// Образ, отображенный в память только для чтения: find и contains идут прямо по
+	// страницам файла. verify - проверить контрольную сумму (читает весь файл).
+	// Определена в MappedSnapshot.h, чтобы системные заголовки не попадали сюда
+	static Mapped map(const std::string& path, bool verify = true) requires IMAGE_SNAPSHOT;
+
+private:
+	//ячейки: состояния, ключи и значения в расположении Layout
+	using Storage = typename Layout::template Storage<K, V, Allocator>;
+
 private:
-	//вспомогательная функция пробинга
-	size_t probe(size_t hash, size_t i) const {		
-		
-		return (hash + i * A + i * i * B) % M;
+	static constexpr double GROWTH_FACTOR = 1.618l;  //золотое сечение
+	static constexpr size_t MIGRATION_BATCH = 64;    //ячеек старой таблицы за одну операцию
+	static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+	using Scheme = ProbeScheme<SizePolicy>;
+
+	//поиск ячейки с ключом в ячейках t (Storage или View снимка) со схемой пробинга s;
+	//NPOS, если ключа нет. probes увеличивается на число просмотренных ячеек
+	template<typename Cells, typename Q>
+	static size_t find_slot(const Cells& t, const Scheme& s, const Q& key, size_t& probes) {
+		ProbeSequence seq = s.start(Hash{}(key));
+		for (size_t i = 0; i < s.size(); ++i, seq.next()) {
+			++probes;
+			size_t index = seq.index();
+			if (t.is_active(index) && KeyEqual{}(t.key(index), key)) {
+				return index;
+			}
+			if (t.is_empty(index)) {
+				return NPOS;  // Дальше искать бессмысленно
+			}
+			// DELETED — продолжаем
+		}
+		return NPOS;
 	}
-	//перегрузка с параметром - для рехэширования
-	size_t probe(size_t hash, size_t i, size_t m) const {
 
-		return (hash + i * A + i * i * B) % m;
+	template<typename Cells, typename Q>
+	static size_t find_slot(const Cells& t, const Scheme& s, const Q& key) {
+		size_t probes = 0;
+		return find_slot(t, s, key, probes);
 	}
 
-	//внутренняя реализация вставки
-	template<typename VFwd>
-	bool insert_impl(K key, VFwd&& value) {
-		size_t hash = std::hash<K>{}(key) % M;
-		int first_deleted = -1;
+	//пакетный поиск в текущей таблице: для блока ключей сначала хеши и предвыборка
+	//домашних ячеек, затем чередующийся пробинг; emit(i, value) - результат для keys[i]
+	template<typename Emit>
+	void lookup_batch(std::span<const K> keys, Emit&& emit) const {
+		struct Lookup {
+			size_t index;       //номер ключа
+			ProbeSequence seq;  //текущая ячейка (уже предвыбрана)
+			size_t probes;
+		};
+		ProbeSequence starts[BATCH_BLOCK];
 
-		for (size_t i = 0; i < M; ++i) {
-			size_t index = probe(hash, i);
-			Entry& entry = table[index];
+		for (size_t begin = 0; begin < keys.size(); begin += BATCH_BLOCK) {
+			size_t count = std::min(BATCH_BLOCK, keys.size() - begin);
+			for (size_t i = 0; i < count; ++i) {
+				starts[i] = scheme.start(Hash{}(keys[begin + i]));
+				table.prefetch(starts[i].index());
+			}
+			interleave_lookups<Lookup>(count,
+				[&](size_t i, Lookup& lookup) {
+					lookup.index = begin + i;
+					lookup.seq = starts[i];
+					lookup.probes = 0;
+				},
+				[&](Lookup& lookup) {
+					size_t index = lookup.seq.index();
+					if (table.is_active(index) && KeyEqual{}(table.key(index), keys[lookup.index])) {
+						counters.on_lookup(lookup.probes + 1, true);
+						emit(lookup.index, &table.value(index));
+						return true;
+					}
+					if (table.is_empty(index) || ++lookup.probes == M) {
+						counters.on_lookup(table.is_empty(index) ? lookup.probes + 1 : lookup.probes, false);
+						emit(lookup.index, nullptr);
+						return true;
+					}
+					// DELETED или чужой ключ - следующая ячейка
+					lookup.seq.next();
+					table.prefetch(lookup.seq.index());
+					return false;
+				});
+		}
+	}
 
-			if (entry.is_active()) {
-				if (entry.key == key) return false;
+	//поиск значения: сначала в текущей таблице, затем в старой (если идет перенос)
+	template<typename Q>
+	const V* find_value(const Q& key) const {
+		size_t probes = 0;
+		size_t index = find_slot(table, scheme, key, probes);
+		if (index != NPOS) {
+			counters.on_lookup(probes, true);
+			return &table.value(index);
+		}
+		if (migrating()) {
+			index = find_slot(old_table, old_scheme, key, probes);
+			if (index != NPOS) {
+				counters.on_lookup(probes, true);
+				return &old_table.value(index);
 			}
-			else if (entry.is_deleted()) {
-				if (first_deleted == -1) first_deleted = index;
+		}
+		counters.on_lookup(probes, false);
+		return nullptr;
+	}
+	template<typename Q>
+	V* find_value(const Q& key) {
+		return const_cast<V*>(std::as_const(*this).find_value(key));
+	}
+
+	//первая активная запись начиная с позиции pos
+	Position active_from(size_t pos) const {
+		for (; pos < M; ++pos) {
+			if (table.is_active(pos)) return { pos };
+		}
+		for (; pos < M + old_M; ++pos) {
+			if (old_table.is_active(pos - M)) return { pos };
+		}
+		return {};
+	}
+
+	//удаление: запись становится надгробием
+	template<typename Q>
+	bool remove_impl(const Q& key) {
+
+		migrate_step();
+
+		size_t index = find_slot(table, scheme, key);
+		if (index != NPOS) {
+			table.set_state(index, EntryState::DELETED);
+			++deleted_count;
+		}
+		else if (migrating() && (index = find_slot(old_table, old_scheme, key)) != NPOS) {
+			old_table.set_state(index, EntryState::DELETED); // надгробия старой таблицы не считаем
+		}
+		else {
+			return false;
+		}
+		--element_count;
+		counters.on_remove();
+		return true;
+	}
+
+	//первая свободная (EMPTY или DELETED) ячейка на пути пробинга
+	size_t free_slot(const Storage& t, const Scheme& s, size_t hash) const {
+		ProbeSequence seq = s.start(hash);
+		for (size_t i = 0; i < s.size(); ++i, seq.next()) {
+			if (!t.is_active(seq.index())) return seq.index();
+		}
+		throw std::runtime_error("Hash table invariant violated");
+	}
+
+	//то же, но пробинг только внутри ячеек [from, to): NPOS, если он выходит за диапазон
+	size_t free_slot_in_range(const Storage& t, const Scheme& s, size_t hash, size_t from, size_t to) const {
+		ProbeSequence seq = s.start(hash);
+		for (size_t i = 0; i < s.size(); ++i, seq.next()) {
+			size_t index = seq.index();
+			if (index < from || index >= to) break;
+			if (!t.is_active(index)) return index;
+		}
+		return NPOS;
+	}
+
+	//перенос активных записей source[from, to) в таблицу target со схемой s
+	void move_entries(Storage& source, Storage& target, const Scheme& s,
+		size_t from, size_t to) {
+
+		for (size_t pos = from; pos < to; ++pos) {
+			if (!source.is_active(pos)) continue;  // только активные
+
+			size_t index = free_slot(target, s, Hash{}(source.key(pos)));
+			if (target.is_deleted(index)) --deleted_count; // надгробие в текущей таблице
+			move_entry(source, pos, target, index);
+		}
+	}
+
+	//перемещение записи source[pos] в свободную ячейку target[index]; в source остается
+	//надгробие: цепочки пробинга еще не перенесенных ключей не должны обрываться
+	static void move_entry(Storage& source, size_t pos, Storage& target, size_t index) {
+		target.key(index) = std::move(source.key(pos));
+		target.value(index) = std::move(source.value(pos));
+		target.set_state(index, EntryState::ACTIVE);
+		source.set_state(pos, EntryState::DELETED);
+	}
+
+	//перенос всех записей source в новую пустую таблицу target в parts потоках: хеши
+	//считаются по диапазонам source, записи разбиваются по диапазонам target, и каждый
+	//поток заполняет только свой. Запись, чей пробинг выходит за диапазон, переносится
+	//затем по одной; если потоки запустить не удалось - все оставшиеся записи
+	void move_entries_parallel(Storage& source, Storage& target, const Scheme& s, size_t parts) {
+		const size_t source_size = source.size();
+		std::vector<std::vector<size_t>> deferred(parts);
+		try {
+			std::vector<size_t> hashes(source_size);
+			run_parallel(parts, [&](size_t part) {
+				for (size_t pos = bulk_bound(source_size, parts, part); pos != bulk_bound(source_size, parts, part + 1); ++pos) {
+					if (source.is_active(pos)) hashes[pos] = Hash{}(source.key(pos));
+				}
+			});
+			BulkPartition partition = partition_by_slot(source_size, s.size(), parts,
+				[&](size_t pos) { return source.is_active(pos) ? s.home(hashes[pos]) : BULK_SKIP; });
+
+			run_parallel(parts, [&](size_t part) {
+				size_t from = bulk_bound(s.size(), parts, part);
+				size_t to = bulk_bound(s.size(), parts, part + 1);
+				for (size_t k = partition.bounds[part]; k != partition.bounds[part + 1]; ++k) {
+					size_t pos = partition.order[k];
+					size_t index = free_slot_in_range(target, s, hashes[pos], from, to);
+					if (index != NPOS) move_entry(source, pos, target, index);
+					else deferred[part].push_back(pos);
+				}
+			});
+		}
+		catch (...) { // потоки или память под них
+			move_entries(source, target, s, 0, source_size);
+			return;
+		}
+		for (const std::vector<size_t>& part : deferred) {
+			for (size_t pos : part) {
+				move_entry(source, pos, target, free_slot(target, s, Hash{}(source.key(pos))));
+			}
+		}
+	}
+
+	//подготовка к вставке: шаг переноса и, при необходимости, расширение или очистка
+	void prepare_insert() {
+		migrate_step();
+		if (needs_space()) {
+			make_space();
+		}
+	}
+
+	//надгробия удлиняют пробинг так же, как живые элементы, и учитываются в пороге
+	bool needs_space() const {
+		return static_cast<double>(element_count + deleted_count) / M >= max_load_factor;
+	}
+
+	//если живых элементов меньше половины порога, занятое место - в основном надгробия:
+	//достаточно перестроить таблицу того же размера, иначе - растем
+	void make_space() {
+		if (element_count < M * max_load_factor / 2) {
+			compact();
+		}
+		else {
+			grow();
+		}
+	}
+
+	//рост таблицы в соответствии с режимом рехэширования;
+	//новый размер всегда допустим для политики и взаимно прост с A и B - исключений нет
+	void grow() {
+		size_t target = static_cast<size_t>(M * GROWTH_FACTOR);
+		size_t new_M = Scheme::valid_grow_size(target > M ? target : M + 1, A, B);
+		if (rehash_mode == RehashMode::STOP_THE_WORLD) {
+			rehash(new_M);
+			return;
+		}
+		// новая таблица заполняется быстрее, чем переносится старая, только
+		// при очень малом max load factor - тогда доводим перенос до конца
+		finish_migration();
+
+		[[maybe_unused]] auto timer = counters.rehash_timer();
+		counters.on_rehash();
+		old_table = std::move(table);
+		old_M = M;
+		old_scheme = scheme;
+		table = Storage(new_M);
+		M = new_M;
+		scheme = Scheme(M, A, B);
+		deleted_count = 0;
+		migrate_pos = 0;
+	}
+
+	//перенос очередной порции ячеек из старой таблицы
+	void migrate_step() {
+		if (!migrating()) return;
+
+		[[maybe_unused]] auto timer = counters.rehash_timer();
+		size_t to = std::min(migrate_pos + MIGRATION_BATCH, old_M);
+		move_entries(old_table, table, scheme, migrate_pos, to);
+		migrate_pos = to;
+
+		if (migrate_pos == old_M) release_old_table();
+	}
+
+	void release_old_table() {
+		old_table = Storage();
+		old_M = 0;
+		migrate_pos = 0;
+	}
+
+	enum class BulkPlacement { INSERTED, PRESENT, DEFERRED };
+
+	//вставка для insert_bulk без выхода за ячейки [from, to): ключ отложен, если пробинг
+	//покидает диапазон раньше, чем станет ясно, что ключа нет. Счетчики не трогает
+	BulkPlacement place_in_range(const std::pair<K, V>& item, size_t hash, size_t from, size_t to,
+		size_t& reused) {
+
+		ProbeSequence seq = scheme.start(hash);
+		size_t first_deleted = NPOS;
+		for (size_t i = 0; i < M; ++i, seq.next()) {
+			size_t index = seq.index();
+			if (index < from || index >= to) break;
+
+			if (table.is_active(index)) {
+				if (KeyEqual{}(table.key(index), item.first)) return BulkPlacement::PRESENT;
+			}
+			else if (table.is_deleted(index)) {
+				if (first_deleted == NPOS) first_deleted = index;
 			}
 			else { // EMPTY
-				int target = (first_deleted != -1) ? first_deleted : index;
-				table[target] =	Entry(std::move(key), std::forward<VFwd>(value));				
-				++element_count;
-				return true;
+				size_t target = first_deleted != NPOS ? first_deleted : index;
+				table.value(target) = item.second;
+				table.key(target) = item.first;
+				if (table.is_deleted(target)) ++reused;
+				table.set_state(target, EntryState::ACTIVE);
+				return BulkPlacement::INSERTED;
 			}
 		}
+		return BulkPlacement::DEFERRED;
+	}
 
-		if (first_deleted != -1) {
-			table[first_deleted] = Entry(std::move(key), std::forward<VFwd>(value));
-			++element_count;
-			return true;
+	//смещения массивов образа от начала файла; последний элемент - конец данных
+	static std::array<size_t, Storage::ARRAYS + 1> image_offsets(size_t size) {
+		std::array<size_t, Storage::ARRAYS + 1> offsets{};
+		size_t offset = sizeof(SnapshotHeader);
+		for (size_t i = 0; i != Storage::ARRAYS; ++i) {
+			offset = (offset + SNAPSHOT_ALIGN - 1) / SNAPSHOT_ALIGN * SNAPSHOT_ALIGN;
+			offsets[i] = offset;
+			offset += Storage::array_bytes(size, i);
 		}
+		offsets[Storage::ARRAYS] = offset;
+		return offsets;
+	}
 
-		throw std::runtime_error("Hash table invariant violated");
+	//заголовок снимка подходит этой таблице
+	static void check_header(const SnapshotHeader& h) {
+		if (std::memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0) {
+			throw std::runtime_error("Snapshot: not a hash table snapshot");
+		}
+		if (h.version != SNAPSHOT_VERSION) throw std::runtime_error("Snapshot: unsupported version");
+		if (h.byte_order != SNAPSHOT_BYTE_ORDER) throw std::runtime_error("Snapshot: different byte order");
+		if (h.buckets == 0 || h.buckets > std::numeric_limits<size_t>::max() / 64
+			|| SizePolicy::round_size(h.buckets) != h.buckets
+			|| (h.a == 0 && h.b == 0)
+			|| (h.a != 0 && std::gcd(h.a, h.buckets) != 1) || (h.b != 0 && std::gcd(h.b, h.buckets) != 1)
+			|| h.size > h.buckets || h.tombstones > h.buckets - h.size
+			|| !(h.max_load_factor > 0 && h.max_load_factor <= 1)) {
+			throw std::runtime_error("Snapshot: invalid table parameters");
+		}
+		if (h.format == static_cast<uint32_t>(SnapshotFormat::STREAM)) return;
+		if (h.format != static_cast<uint32_t>(SnapshotFormat::IMAGE) || !IMAGE_SNAPSHOT) {
+			throw std::runtime_error("Snapshot: unsupported format for this table type");
+		}
+		if (h.layout != Layout::ID || h.key_size != sizeof(K) || h.key_align != alignof(K)
+			|| h.value_size != sizeof(V) || h.value_align != alignof(V)
+			|| h.data_bytes != image_offsets(h.buckets).back() - sizeof(SnapshotHeader)) {
+			throw std::runtime_error("Snapshot: image does not match the table type");
+		}
 	}
 
-private:
-	enum class EntryState { EMPTY, ACTIVE, DELETED }; //виды состояний
+	//внутренняя реализация вставки
+	template<typename VFwd>
+	bool insert_impl(K key, VFwd&& value) {
+		return emplace_impl(std::move(key), std::forward<VFwd>(value)).second;
+	}
 
-	struct Entry { //структура для данных таблицы
-		K key;
-		V value;
-		EntryState state = EntryState::EMPTY;
+	//вставка или замена значения за один проход пробинга
+	template<typename VFwd>
+	bool assign_impl(K key, VFwd&& value) {
+		auto [current, inserted] = emplace_impl(std::move(key), std::forward<VFwd>(value));
+		if (!inserted) *current = std::forward<VFwd>(value); // value не тронут: запись не создавалась
+		return inserted;
+	}
 
-		Entry() = default;		
+	//поиск ключа и, если его нет, заполнение свободной ячейки: ключ переносится
+	//из key, значение строится из args. Возвращает {значение ключа, создана ли запись}
+	template<typename KFwd, typename... Args>
+	std::pair<V*, bool> emplace_impl(KFwd&& key, Args&&... args) {
+		ProbeSequence seq = scheme.start(Hash{}(key));
+		size_t first_deleted = NPOS;
 
-		template<typename KFwd, typename VFwd>
-		Entry(KFwd&& k, VFwd&& v)
-			: key(std::forward<KFwd>(k)),
-			value(std::forward<VFwd>(v)),
-			state(EntryState::ACTIVE) {
+		// ключ может еще лежать в старой таблице
+		if (migrating()) {
+			size_t index = find_slot(old_table, old_scheme, key);
+			if (index != NPOS) return { &old_table.value(index), false };
 		}
 
-		bool is_active() const { return state == EntryState::ACTIVE; }
-		bool is_empty() const { return state == EntryState::EMPTY; }
-		bool is_deleted() const { return state == EntryState::DELETED; }
-	};
+		for (size_t i = 0; i < M; ++i, seq.next()) {
+			size_t index = seq.index();
+
+			if (table.is_active(index)) {
+				if (KeyEqual{}(table.key(index), key)) return { &table.value(index), false };
+			}
+			else if (table.is_deleted(index)) {
+				if (first_deleted == NPOS) first_deleted = index;
+			}
+			else { // EMPTY
+				size_t target = first_deleted != NPOS ? first_deleted : index;
+				return { fill(target, std::forward<KFwd>(key), std::forward<Args>(args)...), true };
+			}
+		}
+
+		if (first_deleted != NPOS) {
+			return { fill(first_deleted, std::forward<KFwd>(key), std::forward<Args>(args)...), true };
+		}
+
+		// при составном M квадратичная цепочка обходит не все ячейки и может
+		// заполниться раньше порога загрузки - расширяем таблицу и повторяем
+		grow();
+		return emplace_impl(std::forward<KFwd>(key), std::forward<Args>(args)...);
+	}
+
+	//запись нового элемента в свободную ячейку текущей таблицы; если конструктор
+	//значения бросит исключение, ячейка останется свободной
+	template<typename KFwd, typename... Args>
+	V* fill(size_t index, KFwd&& key, Args&&... args) {
+		if constexpr (sizeof...(Args) == 1 && (std::same_as<std::remove_cvref_t<Args>, V> && ...)) {
+			table.value(index) = (std::forward<Args>(args), ...); // готовое значение - без временного объекта
+		}
+		else {
+			table.value(index) = V(std::forward<Args>(args)...);
+		}
+		table.key(index) = std::forward<KFwd>(key);
+		if (table.is_deleted(index)) --deleted_count;
+		table.set_state(index, EntryState::ACTIVE);
+		++element_count;
+		counters.on_insert();
+		return &table.value(index);
+	}
+
+private:
+
+	Storage table;
+	size_t M; //размер таблицы
 
-private:		
-	
-	std::vector<Entry> table;
-	size_t M; //размер таблицы	
-	
 	//коэффициенты пробинга
 	size_t A; //линейный
 	size_t B; //квадратичный
 
 	double max_load_factor;
+	RehashMode rehash_mode;
 
-	size_t element_count = 0; //количество "живых" элементов
-};
+	Scheme scheme; //политика размера и приращения пробинга для M
+
+	size_t element_count = 0; //количество "живых" элементов (в обеих таблицах)
+	size_t deleted_count = 0; //количество надгробий в текущей таблице
+
+	//инкрементальное рехэширование
+	Storage old_table;            //таблица, из которой идет перенос
+	size_t old_M = 0;             //ее размер (0 - переноса нет)
+	Scheme old_scheme;            //и схема пробинга
+	size_t migrate_pos = 0;       //первая еще не перенесенная ячейка
+
+	[[no_unique_address]] mutable Stats counters; //статистика операций (NoStats - пусто)
+};
\ No newline at end of file
@@ -0,0 +1,378 @@
+﻿#pragma once
+#include "IHashTable.h"
+#include <iostream>
+#include <vector>
+#include <variant>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+#include "SizePolicy.h"
+
+// Компактная хеш-таблица с порядком вставки: ключи и значения лежат подряд
+// в плотном массиве записей, а хеш-индекс - разреженный массив номеров записей
+// с линейным пробингом. Ширина номера (8/16/32/64 бит) выбирается по емкости индекса,
+// поэтому пустые ячейки стоят 1-8 байт, а не целую запись.
+//   - обход - линейный проход по плотному массиву в порядке вставки
+//   - рехэширование перестраивает только индекс: записи хранят свой хеш и не перемещаются
+//   - удаление переносит последнюю запись на место удаленной (порядок вставки
+//     сохраняется, пока нет удалений), в индексе - обратный сдвиг без надгробий
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+	requires KeyHasher<Hash, K> && KeyEquality<KeyEqual, K>
+class OrderedHashTable final : public IHashTable<K, V> {
+
+	struct Entry;
+
+public:
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using typename IHashTable<K, V>::Position;
+
+	//----------- Конструкторы -------------------//
+	OrderedHashTable() = delete;
+
+	explicit OrderedHashTable(size_t size, double mlf = 0.75) : max_load_factor(mlf) {
+
+		if (size == 0) throw std::invalid_argument("Size must be positive");
+		if (mlf <= 0 || mlf >= 1) {
+			throw std::invalid_argument("Max load factor must be in (0, 1)");
+		}
+		build_index(PowerOfTwoSizePolicy::round_size(size));
+	}
+
+	OrderedHashTable(const OrderedHashTable&) = default;
+
+	OrderedHashTable(OrderedHashTable&& other) noexcept
+		: entries(std::move(other.entries)),
+		index(std::move(other.index)),
+		capacity(std::exchange(other.capacity, 0)),
+		policy(other.policy),
+		max_load_factor(other.max_load_factor)
+	{
+		other.entries.clear();
+	}
+
+	OrderedHashTable& operator=(const OrderedHashTable&) = default;
+
+	OrderedHashTable& operator=(OrderedHashTable&& other) noexcept {
+		if (this != &other) {
+			entries = std::move(other.entries);
+			index = std::move(other.index);
+			capacity = std::exchange(other.capacity, 0);
+			policy = other.policy;
+			max_load_factor = other.max_load_factor;
+			other.entries.clear();
+		}
+		return *this;
+	}
+	virtual ~OrderedHashTable() = default;
+
+	//---------- Основные операции-------------------//
+	//Операции вставки
+	bool insert(K key, const V& value) override {
+		return insert_impl(std::move(key), value);
+	}
+
+	bool insert(K key, V&& value) override {
+		return insert_impl(std::move(key), std::move(value));
+	}
+
+	//операции удаления
+	bool remove(const K& key) override {
+		size_t hash = Hash{}(key);
+		size_t pos = find_pos(key, hash);
+		if (pos == NPOS) return false;
+
+		unlink(pos, hash);
+		size_t last = entries.size() - 1;
+		if (pos != last) { // последняя запись занимает освободившееся место
+			relink(last, pos);
+			entries[pos] = std::move(entries[last]);
+		}
+		entries.pop_back();
+		return true;
+	}
+
+	//операции доступа и поиска
+	bool contains(const K& key) const override {
+		return find_pos(key, Hash{}(key)) != NPOS;
+	}
+
+	V* find(const K& key) override {
+		size_t pos = find_pos(key, Hash{}(key));
+		return pos == NPOS ? nullptr : &entries[pos].value;
+	}
+
+	const V* find(const K& key) const override {
+		size_t pos = find_pos(key, Hash{}(key));
+		return pos == NPOS ? nullptr : &entries[pos].value;
+	}
+
+	V& at(const K& key) override {
+		size_t pos = find_pos(key, Hash{}(key));
+		if (pos == NPOS) throw std::out_of_range("Key not found in hash table");
+		return entries[pos].value;
+	}
+
+	const V& at(const K& key) const override {
+		size_t pos = find_pos(key, Hash{}(key));
+		if (pos == NPOS) throw std::out_of_range("Key not found in hash table");
+		return entries[pos].value;
+	}
+
+	// Только для неконстантных объектов
+	V& operator[](const K& key) override {
+		size_t hash = Hash{}(key);
+		size_t pos = find_pos(key, hash);
+		if (pos != NPOS) return entries[pos].value;
+
+		return entries[append(key, V{}, hash)].value;
+	}
+
+	//очистка
+	void clear() override {
+		entries.clear();
+		build_index(capacity);
+	}
+
+	//---------- Рехэширование -------------------//
+	// Перестраивается только индекс, записи остаются на месте
+	void rehash(size_t new_size) override {
+		if (new_size < entries.size()) {
+			throw std::invalid_argument("rehash: new size too small");
+		}
+		size_t new_capacity = PowerOfTwoSizePolicy::round_size(new_size);
+		// Новый индекс должен вмещать все элементы с учетом max load factor
+		while (new_capacity * max_load_factor <= entries.size()) {
+			new_capacity *= 2;
+		}
+		if (new_capacity == capacity) return;
+
+		build_index(new_capacity);
+	}
+
+	//---------- Характeристики-------------------//
+
+	//максимальное число бакетов (ячеек индекса)
+	[[nodiscard]] size_t max_bucket_count() const noexcept override { return capacity; }
+
+	//фактический размер
+	size_t size() const noexcept override { return entries.size(); }
+
+	//проверка на пустоту
+	bool empty() const noexcept override { return entries.empty(); }
+
+	// Коэффициент заполнения
+	double load_factor() const override {
+		return static_cast<double>(entries.size()) / capacity;
+	}
+
+	//максимальный коэффициент заполнения
+	double get_max_load_factor() const { return max_load_factor; }
+
+	//байт памяти таблицы; память, которой владеют ключи и значения, не учитывается
+	size_t memory_usage() const noexcept {
+		size_t index_bytes = std::visit([](const auto& slots) { return slots.capacity() * sizeof(slots[0]); }, index);
+		return sizeof(*this) + entries.capacity() * sizeof(Entry) + index_bytes;
+	}
+
+	//байт на ячейку индекса
+	size_t index_width() const {
+		return std::visit([](const auto& slots) { return sizeof(slots[0]); }, index);
+	}
+
+	//---------- Обход -------------------//
+	// Позиция - номер записи в плотном массиве
+	Position first_position() const override {
+		return entries.empty() ? Position{} : Position{ 0 };
+	}
+
+	Position next_position(Position at) const override {
+		return at.slot + 1 < entries.size() ? Position{ at.slot + 1 } : Position{};
+	}
+
+	std::pair<const K*, const V*> entry_at(Position at) const override {
+		return { &entries[at.slot].key, &entries[at.slot].value };
+	}
+
+	// Собственные итераторы - указатель на запись, без виртуальных вызовов
+	template<bool Const>
+	class DenseIterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::pair<const K, V>;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::pair<const K&, std::conditional_t<Const, const V&, V&>>;
+
+		struct pointer { //для it->first / it->second
+			reference ref;
+			const reference* operator->() const { return &ref; }
+		};
+
+		DenseIterator() = default;
+
+		//неконстантный итератор приводится к константному
+		operator DenseIterator<true>() const requires (!Const) { return DenseIterator<true>(entry); }
+
+		reference operator*() const { return { entry->key, entry->value }; }
+		pointer operator->() const { return { **this }; }
+
+		DenseIterator& operator++() {
+			++entry;
+			return *this;
+		}
+		DenseIterator operator++(int) {
+			DenseIterator copy = *this;
+			++entry;
+			return copy;
+		}
+
+		bool operator==(const DenseIterator& other) const { return entry == other.entry; }
+
+	private:
+		friend class OrderedHashTable;
+		template<bool> friend class DenseIterator;
+
+		explicit DenseIterator(std::conditional_t<Const, const Entry*, Entry*> e) : entry(e) {}
+
+		std::conditional_t<Const, const Entry*, Entry*> entry = nullptr;
+	};
+
+	using iterator = DenseIterator<false>;
+	using const_iterator = DenseIterator<true>;
+
+	iterator begin() { return iterator(entries.data()); }
+	iterator end() { return iterator(entries.data() + entries.size()); }
+	const_iterator begin() const { return const_iterator(entries.data()); }
+	const_iterator end() const { return const_iterator(entries.data() + entries.size()); }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+
+private:
+	static constexpr double GROWTH_FACTOR = 2.0;
+	static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+	struct Entry { //запись плотного массива
+		K key;
+		V value;
+		size_t hash; //сохраненный хеш: индекс перестраивается без хеш-функции
+	};
+
+	// Индекс: номера записей; пустая ячейка - максимальное значение типа
+	using Index = std::variant<std::vector<uint8_t>, std::vector<uint16_t>,
+		std::vector<uint32_t>, std::vector<uint64_t>>;
+
+	template<typename T>
+	static constexpr T EMPTY = std::numeric_limits<T>::max();
+
+	size_t home(size_t hash) const { return policy.index(hash); }
+	size_t advance(size_t slot) const { return (slot + 1) & (capacity - 1); }
+
+	//номер записи с ключом; NPOS, если ключа нет
+	size_t find_pos(const K& key, size_t hash) const {
+		return std::visit([&](const auto& slots) {
+			using T = typename std::decay_t<decltype(slots)>::value_type;
+			for (size_t slot = home(hash); ; slot = advance(slot)) {
+				T pos = slots[slot];
+				if (pos == EMPTY<T>) return NPOS;
+				const Entry& entry = entries[pos];
+				if (entry.hash == hash && KeyEqual{}(entry.key, key)) return static_cast<size_t>(pos);
+			}
+		}, index);
+	}
+
+	//ячейка индекса, указывающая на запись pos с хешем hash
+	template<typename T>
+	size_t slot_of(const std::vector<T>& slots, size_t pos, size_t hash) const {
+		size_t slot = home(hash);
+		while (slots[slot] != static_cast<T>(pos)) slot = advance(slot);
+		return slot;
+	}
+
+	//новая запись в конец плотного массива; возвращает ее номер
+	template<typename VFwd>
+	size_t append(const K& key, VFwd&& value, size_t hash) {
+		return append(K(key), std::forward<VFwd>(value), hash);
+	}
+
+	template<typename VFwd>
+	size_t append(K&& key, VFwd&& value, size_t hash) {
+		if (entries.size() + 1 > capacity * max_load_factor) {
+			build_index(static_cast<size_t>(capacity * GROWTH_FACTOR));
+		}
+		entries.push_back(Entry{ std::move(key), std::forward<VFwd>(value), hash });
+		link(entries.size() - 1, hash);
+		return entries.size() - 1;
+	}
+
+	//внутренняя реализация вставки
+	template<typename VFwd>
+	bool insert_impl(K key, VFwd&& value) {
+		size_t hash = Hash{}(key);
+		if (find_pos(key, hash) != NPOS) return false;
+
+		append(std::move(key), std::forward<VFwd>(value), hash);
+		return true;
+	}
+
+	//запись номера pos в первую пустую ячейку цепочки
+	void link(size_t pos, size_t hash) {
+		std::visit([&](auto& slots) {
+			using T = typename std::decay_t<decltype(slots)>::value_type;
+			size_t slot = home(hash);
+			while (slots[slot] != EMPTY<T>) slot = advance(slot);
+			slots[slot] = static_cast<T>(pos);
+		}, index);
+	}
+
+	//удаление номера pos из индекса обратным сдвигом: следующие номера цепочки,
+	//которые могут стоять ближе к своей домашней ячейке, сдвигаются в дыру
+	void unlink(size_t pos, size_t hash) {
+		std::visit([&](auto& slots) {
+			using T = typename std::decay_t<decltype(slots)>::value_type;
+			size_t hole = slot_of(slots, pos, hash);
+			for (size_t next = advance(hole); slots[next] != EMPTY<T>; next = advance(next)) {
+				size_t ideal = home(entries[slots[next]].hash);
+				// номер можно сдвинуть, если дыра лежит между его домом и текущей ячейкой
+				bool movable = hole <= next ? (ideal <= hole || ideal > next) : (ideal <= hole && ideal > next);
+				if (movable) {
+					slots[hole] = slots[next];
+					hole = next;
+				}
+			}
+			slots[hole] = EMPTY<T>;
+		}, index);
+	}
+
+	//запись from переезжает на место to: меняем номер в ее ячейке индекса
+	void relink(size_t from, size_t to) {
+		std::visit([&](auto& slots) {
+			using T = typename std::decay_t<decltype(slots)>::value_type;
+			slots[slot_of(slots, from, entries[from].hash)] = static_cast<T>(to);
+		}, index);
+	}
+
+	//перестроение индекса емкости new_capacity по сохраненным хешам записей;
+	//ширина номера - наименьшая, в которую помещаются номера и маркер пустой ячейки
+	void build_index(size_t new_capacity) {
+		capacity = PowerOfTwoSizePolicy::round_size(new_capacity);
+		policy.set(capacity);
+		if (capacity <= EMPTY<uint8_t>) index = std::vector<uint8_t>(capacity, EMPTY<uint8_t>);
+		else if (capacity <= EMPTY<uint16_t>) index = std::vector<uint16_t>(capacity, EMPTY<uint16_t>);
+		else if (capacity <= EMPTY<uint32_t>) index = std::vector<uint32_t>(capacity, EMPTY<uint32_t>);
+		else index = std::vector<uint64_t>(capacity, EMPTY<uint64_t>);
+
+		for (size_t pos = 0; pos < entries.size(); ++pos) {
+			link(pos, entries[pos].hash);
+		}
+	}
+
+private:
+	std::vector<Entry> entries; //записи в порядке вставки
+	Index index;                //хеш-индекс: номера записей
+	size_t capacity = 0;        //ячеек индекса (степень двойки)
+	PowerOfTwoSizePolicy policy;
+
+	double max_load_factor;
+};
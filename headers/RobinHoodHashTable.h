@@ -0,0 +1,270 @@
+﻿#pragma once
+#include "IHashTable.h"
+#include <iostream>
+#include <vector>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+#include "SizePolicy.h"
+
+// Хеш-таблица с открытой адресацией и линейным пробингом по схеме Robin Hood:
+// каждая запись хранит свое расстояние от домашней ячейки, при вставке
+// "бедная" запись (дальше от дома) занимает место "богатой".
+// Поиск останавливается, как только расстояние искомого ключа превышает
+// расстояние записи в ячейке; удаление - обратным сдвигом, без надгробий
+template <typename K, typename V, typename SizePolicy = PowerOfTwoSizePolicy,
+	typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+	requires KeyHasher<Hash, K> && KeyEquality<KeyEqual, K>
+class RobinHoodHashTable final : public IHashTable<K, V> {
+
+public:
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using typename IHashTable<K, V>::Position;
+
+	//----------- Конструкторы -------------------//
+	RobinHoodHashTable() = delete;
+
+	explicit RobinHoodHashTable(size_t size, double mlf = 0.9)
+		: table(SizePolicy::round_size(size)), M(table.size()), max_load_factor(mlf) {
+
+		if (size == 0) throw std::invalid_argument("Size must be positive");
+		if (mlf <= 0 || mlf >= 1) {
+			throw std::invalid_argument("Max load factor must be in (0, 1)");
+		}
+		policy.set(M);
+	}
+
+	RobinHoodHashTable(const RobinHoodHashTable&) = default;
+
+	RobinHoodHashTable(RobinHoodHashTable&& other) noexcept
+		: table(std::move(other.table)),
+		M(std::exchange(other.M, 0)),
+		policy(other.policy),
+		max_load_factor(other.max_load_factor),
+		element_count(std::exchange(other.element_count, 0))
+	{}
+
+	RobinHoodHashTable& operator=(const RobinHoodHashTable&) = default;
+
+	RobinHoodHashTable& operator=(RobinHoodHashTable&& other) noexcept {
+		if (this != &other) {
+			table = std::move(other.table);
+			M = std::exchange(other.M, 0);
+			policy = other.policy;
+			max_load_factor = other.max_load_factor;
+			element_count = std::exchange(other.element_count, 0);
+		}
+		return *this;
+	}
+	virtual ~RobinHoodHashTable() = default;
+
+	//---------- Основные операции-------------------//
+	//Операции вставки
+	bool insert(K key, const V& value) override {
+		if (find_index(key) != NPOS) return false;
+		place(Entry(std::move(key), value));
+		return true;
+	}
+
+	bool insert(K key, V&& value) override {
+		if (find_index(key) != NPOS) return false;
+		place(Entry(std::move(key), std::move(value)));
+		return true;
+	}
+
+	//операции удаления
+	bool remove(const K& key) override {
+		size_t index = find_index(key);
+		if (index == NPOS) return false;
+
+		// обратный сдвиг: следующие записи, живущие не дома, сдвигаются на шаг к дому
+		size_t next = advance(index);
+		while (table[next].dist > 1) {
+			table[index] = std::move(table[next]);
+			--table[index].dist;
+			index = next;
+			next = advance(next);
+		}
+		table[index] = Entry{};
+		--element_count;
+		return true;
+	}
+
+	//операции доступа и поиска
+	bool contains(const K& key) const override {
+		return find_index(key) != NPOS;
+	}
+
+	V* find(const K& key) override {
+		size_t index = find_index(key);
+		return index == NPOS ? nullptr : &table[index].value;
+	}
+
+	const V* find(const K& key) const override {
+		size_t index = find_index(key);
+		return index == NPOS ? nullptr : &table[index].value;
+	}
+
+	V& at(const K& key) override {
+		size_t index = find_index(key);
+		if (index == NPOS) throw std::out_of_range("Key not found in hash table");
+		return table[index].value;
+	}
+
+	const V& at(const K& key) const override {
+		size_t index = find_index(key);
+		if (index == NPOS) throw std::out_of_range("Key not found in hash table");
+		return table[index].value;
+	}
+
+	// Только для неконстантных объектов
+	V& operator[](const K& key) override {
+		size_t index = find_index(key);
+		if (index != NPOS) return table[index].value;
+
+		return table[place(Entry(key, V{}))].value;
+	}
+
+	//очистка
+	void clear() override {
+		table = std::vector<Entry>(M);
+		element_count = 0;
+	}
+
+	//---------- Рехэширование -------------------//
+	void rehash(size_t new_size) override {
+		if (new_size < element_count) {
+			throw std::invalid_argument("rehash: new size too small");
+		}
+		size_t new_M = SizePolicy::round_size(new_size);
+		// Новая таблица должна вмещать все элементы с учетом max load factor
+		while (new_M * max_load_factor <= element_count) {
+			new_M = SizePolicy::round_size(new_M + 1);
+		}
+		if (new_M == M) return;
+
+		std::vector<Entry> old_table = std::move(table);
+		table = std::vector<Entry>(new_M);
+		M = new_M;
+		policy.set(M);
+		element_count = 0;
+
+		for (Entry& old : old_table) {
+			if (old.dist == 0) continue;  // только занятые
+			old.dist = 1;
+			place(std::move(old));
+		}
+	}
+
+	//---------- Характeристики-------------------//
+
+	//максимальное число бакетов
+	[[nodiscard]] size_t max_bucket_count() const noexcept override { return M; }
+
+	//фактический размер
+	size_t size() const noexcept override { return element_count; }
+
+	//проверка на пустоту
+	bool empty() const noexcept override { return element_count == 0; }
+
+	// Коэффициент заполнения
+	double load_factor() const override {
+		return static_cast<double>(element_count) / M;
+	}
+
+	//максимальный коэффициент заполнения
+	double get_max_load_factor() const { return max_load_factor; }
+
+	//байт памяти таблицы; память, которой владеют ключи и значения, не учитывается
+	size_t memory_usage() const noexcept {
+		return sizeof(*this) + table.capacity() * sizeof(Entry);
+	}
+
+	//---------- Обход -------------------//
+	Position first_position() const override { return occupied_from(0); }
+
+	Position next_position(Position at) const override { return occupied_from(at.slot + 1); }
+
+	std::pair<const K*, const V*> entry_at(Position at) const override {
+		return { &table[at.slot].key, &table[at.slot].value };
+	}
+
+private:
+	static constexpr double GROWTH_FACTOR = 2.0;
+	static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+	struct Entry { //структура для данных таблицы
+		K key;
+		V value;
+		uint32_t dist = 0; //расстояние от домашней ячейки + 1; 0 - ячейка пуста
+
+		Entry() = default;
+
+		template<typename KFwd, typename VFwd>
+		Entry(KFwd&& k, VFwd&& v)
+			: key(std::forward<KFwd>(k)),
+			value(std::forward<VFwd>(v)),
+			dist(1) {
+		}
+	};
+
+	//первая занятая ячейка начиная с index
+	Position occupied_from(size_t index) const {
+		for (; index < M; ++index) {
+			if (table[index].dist != 0) return { index };
+		}
+		return {};
+	}
+
+	size_t advance(size_t index) const {
+		return index + 1 == M ? 0 : index + 1;
+	}
+
+	//поиск индекса ячейки с ключом; NPOS, если ключа нет
+	size_t find_index(const K& key) const {
+		size_t index = policy.index(Hash{}(key));
+		for (uint32_t dist = 1; ; ++dist) {
+			const Entry& entry = table[index];
+			// у записи в ячейке расстояние меньше, чем было бы у искомого ключа:
+			// при вставке он вытеснил бы ее, значит, ключа нет
+			if (entry.dist < dist) return NPOS;
+			if (entry.dist == dist && KeyEqual{}(entry.key, key)) return index;
+			index = advance(index);
+		}
+	}
+
+	//размещение новой записи (ключа в таблице нет); возвращает ее индекс
+	size_t place(Entry&& entry) {
+		if (element_count + 1 > M * max_load_factor) {
+			rehash(static_cast<size_t>(M * GROWTH_FACTOR));
+		}
+
+		Entry carry = std::move(entry);
+		size_t index = policy.index(Hash{}(carry.key));
+		size_t placed = NPOS; //где оказалась новая запись
+		for (;;) {
+			Entry& slot = table[index];
+			if (slot.dist == 0) {
+				slot = std::move(carry);
+				++element_count;
+				return placed == NPOS ? index : placed;
+			}
+			if (slot.dist < carry.dist) { // забираем место у "богатой" записи
+				std::swap(slot, carry);
+				if (placed == NPOS) placed = index;
+			}
+			index = advance(index);
+			++carry.dist;
+		}
+	}
+
+private:
+	std::vector<Entry> table;
+	size_t M; //размер таблицы
+	SizePolicy policy;
+
+	double max_load_factor;
+
+	size_t element_count = 0; //количество элементов
+};
@@ -0,0 +1,242 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+#include <numeric>
+#include <stdexcept>
+#include <iterator>
+#include <type_traits>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// Политики размера таблицы: какие размеры допустимы и как хеш
+// сводится к индексу ячейки [0, M).
+// Интерфейс политики:
+//   static size_t round_size(size_t requested) - ближайший допустимый размер >= requested
+//   static size_t grow_size(size_t requested)  - размер для автоматического роста таблицы
+//   void set(size_t m)                         - подготовка констант для размера m
+//   size_t index(size_t hash) const            - индекс домашней ячейки
+//   static constexpr bool TRIANGULAR           - квадратичный член пробинга i(i+1)/2 вместо i²
+// Функции политик constexpr, чтобы ConstexprHashTable раскладывала ключи при компиляции
+
+// Старшие 64 бита произведения 64x64
+constexpr uint64_t mul_high_u64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+	__extension__ typedef unsigned __int128 u128; // расширение GCC/Clang: без предупреждения -Wpedantic
+	return static_cast<uint64_t>((static_cast<u128>(a) * b) >> 64);
+#else
+#if defined(_MSC_VER) && defined(_M_X64)
+	if (!std::is_constant_evaluated()) return __umulh(a, b);
+#endif
+	uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+	uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+	uint64_t lo_lo = a_lo * b_lo;
+	uint64_t hi_lo = a_hi * b_lo;
+	uint64_t lo_hi = a_lo * b_hi;
+	uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+	return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+}
+
+// Размер задается как есть, индекс - остаток от деления (исходное поведение таблиц)
+struct ModuloSizePolicy {
+	static constexpr bool TRIANGULAR = false;
+
+	static constexpr size_t round_size(size_t requested) { return requested; }
+
+	// При автоматическом росте размер - простое число: квадратичная цепочка
+	// по простому модулю обходит (M + 1) / 2 разных ячеек, поэтому при загрузке
+	// меньше 1/2 свободная ячейка на ней всегда есть. По составному модулю
+	// цепочка может обходить лишь малую часть таблицы (при M = 4 - две ячейки)
+	static constexpr size_t grow_size(size_t requested) {
+		size_t m = requested > 2 ? requested | 1 : 2;
+		while (!is_prime(m)) m += 2;
+		return m;
+	}
+
+	constexpr void set(size_t m) { M = m; }
+	constexpr size_t index(size_t hash) const { return hash % M; }
+
+	size_t M = 1;
+
+private:
+	static constexpr bool is_prime(size_t m) {
+		if (m < 4) return m >= 2;
+		if (m % 2 == 0) return false;
+		for (size_t d = 3; d <= m / d; d += 2) {
+			if (m % d == 0) return false;
+		}
+		return true;
+	}
+};
+
+// Размер - степень двойки, индекс - старшие биты произведения на 2^64/φ
+// (фибоначчиево хеширование: перемешивает даже тождественный std::hash для целых).
+// Квадратичный член - треугольные числа: при B нечетном и A = 0 обходятся все ячейки
+struct PowerOfTwoSizePolicy {
+	static constexpr bool TRIANGULAR = true;
+
+	static constexpr size_t round_size(size_t requested) {
+		return std::bit_ceil(requested ? requested : size_t{ 1 });
+	}
+	static constexpr size_t grow_size(size_t requested) { return round_size(requested); }
+
+	constexpr void set(size_t m) { shift = 64 - std::countr_zero(m); }
+	constexpr size_t index(size_t hash) const {
+		// при M = 1 (shift = 64) сдвиг недопустим
+		return shift == 64 ? 0 : static_cast<size_t>(
+			(static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >> shift);
+	}
+
+	int shift = 64;
+};
+
+// Размер - простое число из таблицы, индекс - остаток через умножение
+// на заранее вычисленную константу ceil(2^64 / M) (Lemire fastmod): без деления.
+// Хеш предварительно сворачивается до 32 бит
+struct PrimeSizePolicy {
+	static constexpr bool TRIANGULAR = false;
+
+	struct Prime {
+		uint32_t value;
+		uint64_t magic; // 2^64 / value + 1
+	};
+
+	// простые числа с шагом ~1.33-1.5
+	static constexpr Prime PRIMES[] = {
+		{ 7u, 0x2492492492492493ULL }, { 11u, 0x1745d1745d1745d2ULL },
+		{ 13u, 0x13b13b13b13b13b2ULL }, { 23u, 0x0b21642c8590b217ULL },
+		{ 31u, 0x0842108421084211ULL }, { 47u, 0x0572620ae4c415caULL },
+		{ 61u, 0x04325c53ef368eb1ULL }, { 89u, 0x02e05c0b81702e06ULL },
+		{ 127u, 0x0204081020408103ULL }, { 191u, 0x01571ed3c506b39bULL },
+		{ 251u, 0x0105197f7d734042ULL }, { 383u, 0x00ab1cbdd3e29710ULL },
+		{ 509u, 0x0080c121b28bd1bbULL }, { 761u, 0x00561e46a4d5f338ULL },
+		{ 1021u, 0x004030241b144f3cULL }, { 1531u, 0x002ace569d8342b8ULL },
+		{ 2039u, 0x00202428adc37becULL }, { 3067u, 0x00155e3c993fda9cULL },
+		{ 4093u, 0x00100300901b0511ULL }, { 6143u, 0x000aab1c7684f035ULL },
+		{ 8191u, 0x0008004002001001ULL }, { 12281u, 0x0005561c8ed4d45fULL },
+		{ 16381u, 0x0004003002401b02ULL }, { 24571u, 0x0002aace3abdb9e2ULL },
+		{ 32749u, 0x0002004c0b49acf0ULL }, { 49139u, 0x0001556c7357cf48ULL },
+		{ 65521u, 0x0001000f00e10d30ULL }, { 98299u, 0x0000aaace395a149ULL },
+		{ 131071u, 0x0000800040002001ULL }, { 196597u, 0x000055568e3d5ee2ULL },
+		{ 262139u, 0x0000400050006401ULL }, { 393209u, 0x00002aaadc720130ULL },
+		{ 524287u, 0x0000200004000081ULL }, { 786431u, 0x00001555571c71eeULL },
+		{ 1048573u, 0x0000100003000091ULL }, { 1572853u, 0x00000aaaaf8e3b22ULL },
+		{ 2097143u, 0x00000800024000a3ULL }, { 3145721u, 0x00000555561c71e5ULL },
+		{ 4194301u, 0x0000040000300003ULL }, { 6291449u, 0x000002aaaadc71cbULL },
+		{ 8388593u, 0x00000200003c0008ULL }, { 12582893u, 0x0000015555771c76ULL },
+		{ 16777213u, 0x0000010000030001ULL }, { 25165813u, 0x000000aaaaaf8e3aULL },
+		{ 33554393u, 0x000000800009c001ULL }, { 50331599u, 0x00000055555ac71dULL },
+		{ 67108859u, 0x0000004000005001ULL }, { 100663291u, 0x0000002aaaaace39ULL },
+		{ 134217689u, 0x0000002000009c01ULL }, { 201326557u, 0x000000155555938fULL },
+		{ 268435399u, 0x0000001000003901ULL }, { 402653171u, 0x0000000aaaaab072ULL },
+		{ 536870909u, 0x00000008000000c1ULL }, { 805306357u, 0x000000055555568fULL },
+		{ 1073741789u, 0x0000000400000231ULL }, { 1610612711u, 0x00000002aaaaab5dULL },
+		{ 2147483647u, 0x0000000200000005ULL }, { 3221225461u, 0x0000000155555569ULL },
+		{ 4294967291u, 0x0000000100000006ULL },
+	};
+
+	static constexpr size_t round_size(size_t requested) {
+		return PRIMES[position(requested)].value;
+	}
+	static constexpr size_t grow_size(size_t requested) { return round_size(requested); }
+
+	constexpr void set(size_t m) {
+		const Prime& prime = PRIMES[position(m)];
+		M = prime.value;
+		magic = prime.magic;
+	}
+	constexpr size_t index(size_t hash) const {
+		uint64_t h = static_cast<uint64_t>(hash);
+		uint32_t folded = static_cast<uint32_t>(h ^ (h >> 32));
+		return static_cast<size_t>(mul_high_u64(magic * folded, M));
+	}
+
+	uint64_t M = 7;
+	uint64_t magic = PRIMES[0].magic;
+
+private:
+	static constexpr size_t position(size_t requested) {
+		for (size_t i = 0; i < std::size(PRIMES); ++i) {
+			if (PRIMES[i].value >= requested) return i;
+		}
+		throw std::length_error("Table size exceeds the largest supported prime");
+	}
+};
+
+// Квадратичный пробинг (hash + A·i + B·q(i)) mod M без деления на каждом шаге:
+// смещение растет на приращение, которое само растет на константу.
+// Все величины хранятся уже приведенными по модулю M
+class ProbeSequence {
+
+public:
+	constexpr ProbeSequence() = default;
+	constexpr ProbeSequence(size_t home, size_t step, size_t step_inc, size_t m)
+		: pos(home), step(step), step_inc(step_inc), M(m) {}
+
+	constexpr size_t index() const { return pos; }
+
+	constexpr void next() {
+		pos = add(pos, step);
+		step = add(step, step_inc);
+	}
+
+private:
+	constexpr size_t add(size_t x, size_t y) const {
+		return x >= M - y ? x - (M - y) : x + y;
+	}
+
+	size_t pos = 0;
+	size_t step = 0;
+	size_t step_inc = 0;
+	size_t M = 1;
+};
+
+// Схема пробинга для таблицы конкретного размера: политика размера
+// плюс заранее вычисленные приращения для коэффициентов A и B
+template <typename SizePolicy>
+class ProbeScheme {
+
+public:
+	ProbeScheme() = default;
+
+	constexpr ProbeScheme(size_t m, size_t a, size_t b) : M(m) {
+		policy.set(m);
+		// i² : приращения A + B(2i + 1), шаг 2B; i(i+1)/2 : приращения A + B(i + 1), шаг B
+		first_step = (a % M + b % M) % M;
+		step_inc = SizePolicy::TRIANGULAR ? b % M : (2 * (b % M)) % M;
+	}
+
+	constexpr size_t size() const { return M; }
+	constexpr size_t home(size_t hash) const { return policy.index(hash); }
+
+	constexpr ProbeSequence start(size_t hash) const {
+		return ProbeSequence(home(hash), first_step, step_inc, M);
+	}
+
+	// Ближайший к requested допустимый размер, взаимно простой с ненулевыми A и B
+	// (такой размер должен существовать - это проверяет конструктор таблицы)
+	static constexpr size_t valid_size(size_t requested, size_t a, size_t b) {
+		return coprime_size(requested, a, b, &SizePolicy::round_size);
+	}
+
+	// То же для автоматического роста таблицы (через SizePolicy::grow_size)
+	static constexpr size_t valid_grow_size(size_t requested, size_t a, size_t b) {
+		return coprime_size(requested, a, b, &SizePolicy::grow_size);
+	}
+
+private:
+	static constexpr size_t coprime_size(size_t requested, size_t a, size_t b, size_t (*round)(size_t)) {
+		size_t m = round(requested);
+		while ((a != 0 && std::gcd(a, m) != 1) || (b != 0 && std::gcd(b, m) != 1)) {
+			m = round(m + 1);
+		}
+		return m;
+	}
+
+	SizePolicy policy;
+	size_t M = 1;
+	size_t first_step = 0;
+	size_t step_inc = 0;
+};
@@ -0,0 +1,226 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <concepts>
+
+// Двоичные снимки таблиц (OpenHashTable::save / load / map).
+// Файл: заголовок SnapshotHeader, данные, контрольная сумма (uint64_t) заголовка и данных.
+// Данные - либо образ массивов ячеек как есть (IMAGE, для тривиально копируемых K и V;
+// такой снимок можно отобразить в память и искать в нем без разбора), либо
+// последовательность пар ключ-значение, записанных SnapshotCodec (STREAM).
+// Числа пишутся в порядке байт машины: снимок переносим только между одинаковыми платформами
+
+constexpr char SNAPSHOT_MAGIC[8] = { 'H', 'T', 'S', 'N', 'A', 'P', '\0', '\0' };
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+constexpr uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+constexpr size_t SNAPSHOT_ALIGN = 64; //выравнивание массивов образа от начала файла
+
+enum class SnapshotFormat : uint32_t {
+	IMAGE = 1,  // массивы ячеек как есть
+	STREAM = 2  // пары ключ-значение через SnapshotCodec
+};
+
+struct SnapshotHeader {
+	char magic[8];          //SNAPSHOT_MAGIC
+	uint32_t version;       //SNAPSHOT_VERSION
+	uint32_t byte_order;    //SNAPSHOT_BYTE_ORDER в порядке байт записавшей машины
+	uint32_t format;        //SnapshotFormat
+	uint32_t layout;        //Layout::ID (для образа)
+	uint64_t key_size;      //sizeof и alignof ключа и значения (для образа)
+	uint64_t key_align;
+	uint64_t value_size;
+	uint64_t value_align;
+	uint64_t buckets;       //размер таблицы M
+	uint64_t a;             //коэффициенты пробинга
+	uint64_t b;
+	uint64_t size;          //живых элементов
+	uint64_t tombstones;    //надгробий (в образе)
+	double max_load_factor;
+	uint64_t data_bytes;    //байт от конца заголовка до контрольной суммы
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+
+// Контрольная сумма: 64-битное перемешивание по словам из 8 байт
+class SnapshotChecksum {
+public:
+	void update(const void* data, size_t bytes) {
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		total += bytes;
+		for (; bytes != 0 && filled != 0; --bytes) {
+			push_byte(*p++);
+		}
+		for (; bytes >= 8; bytes -= 8, p += 8) {
+			uint64_t word;
+			std::memcpy(&word, p, 8);
+			mix(word);
+		}
+		for (; bytes != 0; --bytes) {
+			push_byte(*p++);
+		}
+	}
+
+	uint64_t value() const {
+		uint64_t tail = 0;
+		std::memcpy(&tail, buffer, filled);
+		uint64_t h = state ^ (tail * K1) ^ (total * K2);
+		h ^= h >> 33;
+		h *= K1;
+		h ^= h >> 29;
+		return h;
+	}
+
+private:
+	static constexpr uint64_t K1 = 0x9E3779B97F4A7C15ull;
+	static constexpr uint64_t K2 = 0xC2B2AE3D27D4EB4Full;
+
+	void mix(uint64_t word) {
+		state ^= word * K2;
+		state = (state << 31 | state >> 33) * K1;
+	}
+
+	void push_byte(unsigned char byte) {
+		buffer[filled % sizeof(buffer)] = byte; // filled < 8 всегда
+		if (++filled == 8) {
+			uint64_t word;
+			std::memcpy(&word, buffer, 8);
+			mix(word);
+			filled = 0;
+		}
+	}
+
+	uint64_t state = 0x243F6A8885A308D3ull;
+	uint64_t total = 0;
+	unsigned char buffer[8] = {};
+	size_t filled = 0;
+};
+
+// Запись снимка в поток с подсчетом контрольной суммы
+class SnapshotWriter {
+public:
+	explicit SnapshotWriter(std::ostream& o) : out(o) {}
+
+	void write(const void* data, size_t bytes) {
+		out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+		if (!out) throw std::runtime_error("Snapshot: write failed");
+		checksum.update(data, bytes);
+		written += bytes;
+	}
+
+	template <typename T> requires std::is_trivially_copyable_v<T>
+	void write_value(const T& value) { write(&value, sizeof(T)); }
+
+	//нули до границы alignment от начала снимка
+	void pad(size_t alignment) {
+		static constexpr char zeros[SNAPSHOT_ALIGN] = {};
+		while (written % alignment != 0) {
+			write(zeros, std::min(alignment - written % alignment, sizeof(zeros)));
+		}
+	}
+
+	size_t position() const { return written; }
+
+	//контрольная сумма в конец
+	void finish() {
+		uint64_t sum = checksum.value();
+		out.write(reinterpret_cast<const char*>(&sum), sizeof(sum));
+		if (!out) throw std::runtime_error("Snapshot: write failed");
+	}
+
+private:
+	std::ostream& out;
+	SnapshotChecksum checksum;
+	size_t written = 0;
+};
+
+// Чтение снимка из потока с проверкой контрольной суммы в finish()
+class SnapshotReader {
+public:
+	explicit SnapshotReader(std::istream& i) : in(i) {}
+
+	void read(void* data, size_t bytes) {
+		in.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+		if (!in) throw std::runtime_error("Snapshot: unexpected end of data");
+		checksum.update(data, bytes);
+		consumed += bytes;
+	}
+
+	template <typename T> requires std::is_trivially_copyable_v<T>
+	T read_value() {
+		T value;
+		read(&value, sizeof(T));
+		return value;
+	}
+
+	//пропуск выравнивания, записанного SnapshotWriter::pad
+	void skip_padding(size_t alignment) {
+		char skipped[SNAPSHOT_ALIGN];
+		while (consumed % alignment != 0) {
+			read(skipped, std::min(alignment - consumed % alignment, sizeof(skipped)));
+		}
+	}
+
+	size_t position() const { return consumed; }
+
+	void finish() {
+		uint64_t expected = checksum.value();
+		uint64_t stored = 0;
+		in.read(reinterpret_cast<char*>(&stored), sizeof(stored));
+		if (!in) throw std::runtime_error("Snapshot: unexpected end of data");
+		if (stored != expected) throw std::runtime_error("Snapshot: checksum mismatch");
+	}
+
+private:
+	std::istream& in;
+	SnapshotChecksum checksum;
+	size_t consumed = 0;
+};
+
+// Запись и чтение значений в формате STREAM. Для своих типов - специализация
+// с теми же static write(SnapshotWriter&, const T&) и read(SnapshotReader&)
+template <typename T>
+struct SnapshotCodec;
+
+template <typename T> requires std::is_trivially_copyable_v<T>
+struct SnapshotCodec<T> {
+	static void write(SnapshotWriter& out, const T& value) { out.write_value(value); }
+	static T read(SnapshotReader& in) { return in.read_value<T>(); }
+};
+
+template <typename Char, typename Traits, typename Alloc> requires std::is_trivially_copyable_v<Char>
+struct SnapshotCodec<std::basic_string<Char, Traits, Alloc>> {
+	using String = std::basic_string<Char, Traits, Alloc>;
+
+	static void write(SnapshotWriter& out, const String& value) {
+		out.write_value(static_cast<uint64_t>(value.size()));
+		out.write(value.data(), value.size() * sizeof(Char));
+	}
+
+	static String read(SnapshotReader& in) {
+		uint64_t length = in.read_value<uint64_t>();
+		String value;
+		// длина из файла не заслуживает доверия: строка растет по мере чтения
+		constexpr size_t CHUNK = 4096;
+		while (value.size() < length) {
+			size_t offset = value.size();
+			size_t n = static_cast<size_t>(std::min<uint64_t>(CHUNK, length - offset));
+			value.resize(offset + n);
+			in.read(value.data() + offset, n * sizeof(Char));
+		}
+		return value;
+	}
+};
+
+template <typename T>
+concept SnapshotStreamable = requires(SnapshotWriter& out, SnapshotReader& in, const T& value) {
+	SnapshotCodec<T>::write(out, value);
+	{ SnapshotCodec<T>::read(in) } -> std::convertible_to<T>;
+};
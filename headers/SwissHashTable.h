@@ -0,0 +1,387 @@
+﻿#pragma once
+#include "IHashTable.h"
+#include "Hashers.h"
+#include <iostream>
+#include <vector>
+#include <stdexcept>
+#include <cstdint>
+#include <bit>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SWISS_TABLE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SWISS_TABLE_SSE2
+#endif
+
+// Хеш-таблица с открытой адресацией в стиле Swiss Table:
+// состояние ячеек вынесено в отдельный массив управляющих байтов,
+// в каждом байте хранится 7 бит хеша (h2) или маркер EMPTY/DELETED.
+// Поиск сравнивает сразу целую группу байтов (SSE2/AVX2, либо скалярно),
+// и обращается к ключу только при совпадении h2
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+	requires KeyHasher<Hash, K> && KeyEquality<KeyEqual, K>
+class SwissHashTable final : public IHashTable<K, V> {
+
+public:
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using typename IHashTable<K, V>::Position;
+
+	//----------- Конструкторы -------------------//
+	SwissHashTable() = delete;
+
+	explicit SwissHashTable(size_t size, double mlf = 0.875)
+		: max_load_factor(mlf) {
+
+		if (size == 0) throw std::invalid_argument("Size must be positive");
+		if (mlf <= 0 || mlf >= 1) {
+			throw std::invalid_argument("Max load factor must be in (0, 1)");
+		}
+		allocate(capacity_for(size));
+	}
+
+	SwissHashTable(const SwissHashTable&) = default;
+
+	SwissHashTable(SwissHashTable&& other) noexcept
+		: ctrl(std::move(other.ctrl)),
+		slots(std::move(other.slots)),
+		capacity(std::exchange(other.capacity, 0)),
+		group_mask(std::exchange(other.group_mask, 0)),
+		max_load_factor(other.max_load_factor),
+		element_count(std::exchange(other.element_count, 0)),
+		deleted_count(std::exchange(other.deleted_count, 0))
+	{}
+
+	SwissHashTable& operator=(const SwissHashTable&) = default;
+
+	SwissHashTable& operator=(SwissHashTable&& other) noexcept {
+		if (this != &other) {
+			ctrl = std::move(other.ctrl);
+			slots = std::move(other.slots);
+			capacity = std::exchange(other.capacity, 0);
+			group_mask = std::exchange(other.group_mask, 0);
+			max_load_factor = other.max_load_factor;
+			element_count = std::exchange(other.element_count, 0);
+			deleted_count = std::exchange(other.deleted_count, 0);
+		}
+		return *this;
+	}
+	virtual ~SwissHashTable() = default;
+
+	//---------- Основные операции-------------------//
+	//Операции вставки
+	bool insert(K key, const V& value) override {
+		return insert_impl(std::move(key), value);
+	}
+
+	bool insert(K key, V&& value) override {
+		return insert_impl(std::move(key), std::move(value));
+	}
+
+	//операции удаления
+	bool remove(const K& key) override {
+		size_t index = find_index(key);
+		if (index == NPOS) return false;
+
+		// Если в группе уже есть пустая ячейка, поиск в любом случае
+		// остановится на этой группе - надгробие не нужно
+		Group group(&ctrl[index & ~(Group::WIDTH - 1)]);
+		if (group.match_empty()) {
+			ctrl[index] = CTRL_EMPTY;
+		}
+		else {
+			ctrl[index] = CTRL_DELETED;
+			++deleted_count;
+		}
+		slots[index] = Slot{};
+		--element_count;
+		return true;
+	}
+
+	//операции доступа и поиска
+	bool contains(const K& key) const override {
+		return find_index(key) != NPOS;
+	}
+
+	V* find(const K& key) override {
+		size_t index = find_index(key);
+		return index == NPOS ? nullptr : &slots[index].value;
+	}
+
+	const V* find(const K& key) const override {
+		size_t index = find_index(key);
+		return index == NPOS ? nullptr : &slots[index].value;
+	}
+
+	V& at(const K& key) override {
+		size_t index = find_index(key);
+		if (index == NPOS) throw std::out_of_range("Key not found in hash table");
+		return slots[index].value;
+	}
+
+	const V& at(const K& key) const override {
+		size_t index = find_index(key);
+		if (index == NPOS) throw std::out_of_range("Key not found in hash table");
+		return slots[index].value;
+	}
+
+	// Только для неконстантных объектов
+	V& operator[](const K& key) override {
+		size_t index = find_index(key);
+		if (index != NPOS) return slots[index].value;
+
+		index = prepare_insert(hash_of(key));
+		slots[index] = Slot{ key, V{} };
+		return slots[index].value;
+	}
+
+	//очистка
+	void clear() override {
+		allocate(capacity);
+	}
+
+	//---------- Рехэширование -------------------//
+	void rehash(size_t new_size) override {
+		if (new_size < element_count) {
+			throw std::invalid_argument("rehash: new size too small");
+		}
+		size_t new_capacity = capacity_for(new_size);
+		// Новая таблица должна вмещать все элементы с учетом max load factor
+		while (new_capacity * max_load_factor <= element_count) {
+			new_capacity *= 2;
+		}
+		if (new_capacity == capacity && deleted_count == 0) return;
+
+		resize(new_capacity);
+	}
+
+	//---------- Характeристики-------------------//
+
+	//максимальное число бакетов
+	[[nodiscard]] size_t max_bucket_count() const noexcept override { return capacity; }
+
+	//фактический размер
+	size_t size() const noexcept override { return element_count; }
+
+	//проверка на пустоту
+	bool empty() const noexcept override { return element_count == 0; }
+
+	// Коэффициент заполнения
+	double load_factor() const override {
+		return static_cast<double>(element_count) / capacity;
+	}
+
+	//максимальный коэффициент заполнения
+	double get_max_load_factor() const { return max_load_factor; }
+
+	//байт памяти таблицы; память, которой владеют ключи и значения, не учитывается
+	size_t memory_usage() const noexcept {
+		return sizeof(*this) + ctrl.capacity() * sizeof(int8_t) + slots.capacity() * sizeof(Slot);
+	}
+
+	//---------- Обход -------------------//
+	Position first_position() const override { return full_from(0); }
+
+	Position next_position(Position at) const override { return full_from(at.slot + 1); }
+
+	std::pair<const K*, const V*> entry_at(Position at) const override {
+		return { &slots[at.slot].key, &slots[at.slot].value };
+	}
+
+private:
+	//управляющие байты: старший бит установлен - ячейка свободна
+	static constexpr int8_t CTRL_EMPTY = -128;  // 0b10000000
+	static constexpr int8_t CTRL_DELETED = -2;  // 0b11111110
+
+	static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+	// Группа управляющих байтов, сравниваемая за одну операцию.
+	// Маска результата: бит i установлен, если байт i подходит
+#if defined(SWISS_TABLE_AVX2)
+	struct Group {
+		static constexpr size_t WIDTH = 32;
+
+		explicit Group(const int8_t* pos)
+			: ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos))) {}
+
+		uint32_t match(int8_t h2) const {
+			return static_cast<uint32_t>(_mm256_movemask_epi8(
+				_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl)));
+		}
+		uint32_t match_empty() const { return match(CTRL_EMPTY); }
+		uint32_t match_empty_or_deleted() const { // ctrl < -1
+			return static_cast<uint32_t>(_mm256_movemask_epi8(
+				_mm256_cmpgt_epi8(_mm256_set1_epi8(-1), ctrl)));
+		}
+
+		__m256i ctrl;
+	};
+#elif defined(SWISS_TABLE_SSE2)
+	struct Group {
+		static constexpr size_t WIDTH = 16;
+
+		explicit Group(const int8_t* pos)
+			: ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+		uint32_t match(int8_t h2) const {
+			return static_cast<uint32_t>(_mm_movemask_epi8(
+				_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+		}
+		uint32_t match_empty() const { return match(CTRL_EMPTY); }
+		uint32_t match_empty_or_deleted() const { // ctrl < -1
+			return static_cast<uint32_t>(_mm_movemask_epi8(
+				_mm_cmplt_epi8(ctrl, _mm_set1_epi8(-1))));
+		}
+
+		__m128i ctrl;
+	};
+#else
+	struct Group { // скалярный вариант
+		static constexpr size_t WIDTH = 16;
+
+		explicit Group(const int8_t* pos) : ctrl(pos) {}
+
+		uint32_t match(int8_t h2) const {
+			uint32_t mask = 0;
+			for (size_t i = 0; i < WIDTH; ++i) {
+				if (ctrl[i] == h2) mask |= 1u << i;
+			}
+			return mask;
+		}
+		uint32_t match_empty() const { return match(CTRL_EMPTY); }
+		uint32_t match_empty_or_deleted() const {
+			uint32_t mask = 0;
+			for (size_t i = 0; i < WIDTH; ++i) {
+				if (ctrl[i] < -1) mask |= 1u << i;
+			}
+			return mask;
+		}
+
+		const int8_t* ctrl;
+	};
+#endif
+
+	struct Slot { //ключ и значение - без поля состояния
+		K key;
+		V value;
+	};
+
+	//перемешивание хеша (финализатор murmur3): std::hash для целых - тождественная функция,
+	//а нам нужны "случайные" младшие 7 бит для h2
+	static uint64_t hash_of(const K& key) {
+		return murmur_mix(static_cast<uint64_t>(Hash{}(key)));
+	}
+	static int8_t h2_of(uint64_t hash) { return static_cast<int8_t>(hash & 0x7F); }
+	static size_t h1_of(uint64_t hash) { return static_cast<size_t>(hash >> 7); }
+
+	//первая занятая ячейка начиная с index (занятая - старший бит сброшен)
+	Position full_from(size_t index) const {
+		for (; index < capacity; ++index) {
+			if (ctrl[index] >= 0) return { index };
+		}
+		return {};
+	}
+
+	//минимальная допустимая емкость: степень двойки, кратная ширине группы
+	static size_t capacity_for(size_t size) {
+		return std::bit_ceil(size < Group::WIDTH ? Group::WIDTH : size);
+	}
+
+	void allocate(size_t new_capacity) {
+		capacity = new_capacity;
+		group_mask = capacity / Group::WIDTH - 1;
+		ctrl.assign(capacity, CTRL_EMPTY);
+		slots = std::vector<Slot>(capacity);
+		element_count = 0;
+		deleted_count = 0;
+	}
+
+	//поиск индекса ячейки с ключом; NPOS, если ключа нет
+	size_t find_index(const K& key) const {
+		uint64_t hash = hash_of(key);
+		int8_t h2 = h2_of(hash);
+		size_t group = h1_of(hash) & group_mask;
+
+		// треугольный пробинг по группам: при числе групп = 2^k обходит все
+		for (size_t i = 1; i <= group_mask + 1; ++i) {
+			size_t base = group * Group::WIDTH;
+			Group g(&ctrl[base]);
+			for (uint32_t mask = g.match(h2); mask; mask &= mask - 1) {
+				size_t index = base + std::countr_zero(mask);
+				if (KeyEqual{}(slots[index].key, key)) return index;
+			}
+			if (g.match_empty()) return NPOS; // дальше искать бессмысленно
+			group = (group + i) & group_mask;
+		}
+		return NPOS;
+	}
+
+	//первая свободная (EMPTY или DELETED) ячейка на пути пробинга
+	size_t find_free(uint64_t hash) const {
+		size_t group = h1_of(hash) & group_mask;
+		for (size_t i = 1; i <= group_mask + 1; ++i) {
+			size_t base = group * Group::WIDTH;
+			uint32_t mask = Group(&ctrl[base]).match_empty_or_deleted();
+			if (mask) return base + std::countr_zero(mask);
+			group = (group + i) & group_mask;
+		}
+		throw std::runtime_error("Hash table invariant violated");
+	}
+
+	//резервирует ячейку под новый ключ (при необходимости расширяя таблицу)
+	size_t prepare_insert(uint64_t hash) {
+		size_t index = find_free(hash);
+		if (ctrl[index] == CTRL_EMPTY &&
+			element_count + deleted_count + 1 > capacity * max_load_factor) {
+			// надгробия занимают больше половины - достаточно перестроить на месте,
+			// иначе растем вдвое
+			resize(deleted_count > element_count ? capacity : capacity * 2);
+			index = find_free(hash);
+		}
+		if (ctrl[index] == CTRL_DELETED) --deleted_count;
+		ctrl[index] = h2_of(hash);
+		++element_count;
+		return index;
+	}
+
+	//внутренняя реализация вставки
+	template<typename VFwd>
+	bool insert_impl(K key, VFwd&& value) {
+		if (find_index(key) != NPOS) return false;
+
+		size_t index = prepare_insert(hash_of(key));
+		slots[index] = Slot{ std::move(key), std::forward<VFwd>(value) };
+		return true;
+	}
+
+	//перенос всех элементов в таблицу новой емкости
+	void resize(size_t new_capacity) {
+		std::vector<int8_t> old_ctrl = std::move(ctrl);
+		std::vector<Slot> old_slots = std::move(slots);
+
+		allocate(new_capacity);
+		for (size_t i = 0; i < old_ctrl.size(); ++i) {
+			if (old_ctrl[i] < 0) continue;  // только занятые
+
+			uint64_t hash = hash_of(old_slots[i].key);
+			size_t index = find_free(hash);
+			ctrl[index] = h2_of(hash);
+			slots[index] = std::move(old_slots[i]);
+			++element_count;
+		}
+	}
+
+private:
+	std::vector<int8_t> ctrl;  //управляющие байты
+	std::vector<Slot> slots;   //ключи и значения
+	size_t capacity = 0;       //число ячеек (степень двойки)
+	size_t group_mask = 0;     //число групп - 1
+
+	double max_load_factor;
+
+	size_t element_count = 0;  //количество "живых" элементов
+	size_t deleted_count = 0;  //количество надгробий
+};
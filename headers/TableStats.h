@@ -0,0 +1,139 @@
+﻿#pragma once
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+
+// Сводка о состоянии таблицы: stats() у ChainHashTable и OpenHashTable.
+// Структурная часть считается обходом таблицы при вызове, счетчики операций
+// ведет политика статистики (параметр шаблона Stats)
+struct TableStats {
+	static constexpr size_t HISTOGRAM_SIZE = 32; //последняя корзина - HISTOGRAM_SIZE - 1 проб и больше
+
+	using Histogram = std::array<uint64_t, HISTOGRAM_SIZE>;
+
+	//---------- Структура -------------------//
+	size_t size = 0;
+	size_t buckets = 0;
+	double load_factor = 0;
+	size_t empty_buckets = 0;
+	double empty_bucket_ratio = 0;
+	size_t tombstones = 0;           //надгробия (OpenHashTable)
+	size_t max_chain_length = 0;     //длиннейшая цепочка; для OpenHashTable - длиннейший путь пробинга до ключа
+	double average_chain_length = 0; //средняя длина непустой цепочки; для OpenHashTable - средний путь пробинга
+
+	//---------- Счетчики (CountingStats) -------------------//
+	bool counting = false;  //false - счетчики выключены и равны нулю
+	Histogram hit_probes{}; //hit_probes[n] - число успешных поисков за n проб (сравнений ключа / ячеек)
+	Histogram miss_probes{};
+	uint64_t inserts = 0;   //добавленные ключи
+	uint64_t removes = 0;   //удаленные ключи
+	uint64_t rehashes = 0;  //перестроения таблицы (рост, rehash, уплотнение)
+	std::chrono::nanoseconds rehash_time{ 0 }; //суммарное время перестроений и переноса
+
+	uint64_t hits() const { return std::accumulate(hit_probes.begin(), hit_probes.end(), uint64_t{ 0 }); }
+	uint64_t misses() const { return std::accumulate(miss_probes.begin(), miss_probes.end(), uint64_t{ 0 }); }
+	uint64_t lookups() const { return hits() + misses(); }
+
+	//среднее число проб по гистограмме (последняя корзина считается как HISTOGRAM_SIZE - 1)
+	static double average(const Histogram& histogram) {
+		uint64_t count = 0;
+		uint64_t probes = 0;
+		for (size_t n = 0; n < HISTOGRAM_SIZE; ++n) {
+			count += histogram[n];
+			probes += histogram[n] * n;
+		}
+		return count ? static_cast<double>(probes) / count : 0.0;
+	}
+};
+
+// Политика статистики: таблица сообщает о поисках, вставках, удалениях и перестроениях.
+// Вызовы идут и из константных методов, поэтому таблицы хранят политику как mutable
+template<typename S>
+concept StatsPolicy = std::default_initializable<S> && std::copyable<S>
+	&& requires(S& stats, const S& cstats, size_t probes, bool hit, TableStats& out) {
+		{ S::enabled } -> std::convertible_to<bool>;
+		stats.on_lookup(probes, hit);
+		stats.on_insert();
+		stats.on_remove();
+		stats.on_rehash();
+		stats.rehash_timer();
+		stats.reset();
+		cstats.report(out);
+	};
+
+// Статистика выключена (по умолчанию): все вызовы пустые и исчезают при компиляции
+struct NoStats {
+	static constexpr bool enabled = false;
+
+	struct Timer {};
+
+	void on_lookup(size_t, bool) noexcept {}
+	void on_insert() noexcept {}
+	void on_remove() noexcept {}
+	void on_rehash() noexcept {}
+	Timer rehash_timer() noexcept { return {}; }
+	void reset() noexcept {}
+	void report(TableStats&) const noexcept {}
+};
+
+// Счетчики операций и гистограммы длины пробинга. Не потокобезопасны:
+// константный поиск тоже пишет в счетчики, поэтому в ConcurrentShardedHashTable
+// с параллельными чтениями ее использовать нельзя
+class CountingStats {
+public:
+	static constexpr bool enabled = true;
+
+	// Время перестроения: от создания до разрушения, вложенные таймеры не учитываются
+	class Timer {
+	public:
+		explicit Timer(CountingStats& s) : stats(s) {
+			if (stats.timer_depth++ == 0) start = std::chrono::steady_clock::now();
+		}
+		~Timer() {
+			if (--stats.timer_depth == 0) stats.rehash_time += std::chrono::steady_clock::now() - start;
+		}
+		Timer(const Timer&) = delete;
+		Timer& operator=(const Timer&) = delete;
+
+	private:
+		CountingStats& stats;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	void on_lookup(size_t probes, bool hit) noexcept {
+		size_t bucket = probes < TableStats::HISTOGRAM_SIZE ? probes : TableStats::HISTOGRAM_SIZE - 1;
+		++(hit ? hit_probes : miss_probes)[bucket];
+	}
+	void on_insert() noexcept { ++inserts; }
+	void on_remove() noexcept { ++removes; }
+	void on_rehash() noexcept { ++rehashes; }
+	Timer rehash_timer() { return Timer(*this); }
+
+	void reset() noexcept {
+		size_t depth = timer_depth;
+		*this = CountingStats();
+		timer_depth = depth;
+	}
+
+	void report(TableStats& out) const noexcept {
+		out.counting = true;
+		out.hit_probes = hit_probes;
+		out.miss_probes = miss_probes;
+		out.inserts = inserts;
+		out.removes = removes;
+		out.rehashes = rehashes;
+		out.rehash_time = std::chrono::duration_cast<std::chrono::nanoseconds>(rehash_time);
+	}
+
+private:
+	TableStats::Histogram hit_probes{};
+	TableStats::Histogram miss_probes{};
+	uint64_t inserts = 0;
+	uint64_t removes = 0;
+	uint64_t rehashes = 0;
+	std::chrono::steady_clock::duration rehash_time{ 0 };
+	size_t timer_depth = 0;
+};
@@ -0,0 +1,853 @@
+﻿#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <filesystem>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <type_traits>
+#include <span>
+#include <utility>
+#include "ChainHashTable.h"
+#include "OpenHashTable.h"
+#include "MappedSnapshot.h"
+#include "SwissHashTable.h"
+#include "RobinHoodHashTable.h"
+#include "CuckooHashTable.h"
+#include "LockFreeHashTable.h"
+#include "ConcurrentShardedHashTable.h"
+#include "ConstexprHashTable.h"
+#include "OrderedHashTable.h"
+#include "CountingAllocator.h"
+#include "Hashers.h"
+
+// Микробенчмарк таблиц: время одной операции в наносекундах (среднее, p50, p99, max)
+// на разных распределениях ключей, попаданиях и промахах, смешанной нагрузке,
+// строковых ключах и разных коэффициентах заполнения, и байт памяти на элемент
+// (memory_usage()). std::unordered_map - базовая линия. OpenHashTable меряется и с
+// хеш-функциями из Hashers.h, вместе со средней длиной пробинга (average_probe_length()).
+// Там, где таблица это умеет, - пакетный поиск, обход (своими итераторами и через
+// IHashTable), рехэширование в один и несколько потоков, снимки, смешанная нагрузка
+// из нескольких потоков и поиск по std::string_view; отдельно - ConstexprHashTable
+//
+// Запуск: HashTablesBench [--size N] [--format csv|json] [--out файл] [--table подстрока]
+//
+// Часы читаются раз в BATCH операций (чтение часов само стоит десятки наносекунд),
+// поэтому перцентили - по пачкам из BATCH операций, а не по одиночным операциям
+
+using Value = uint64_t;
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t BATCH = 16;
+
+// не дает компилятору выбросить результаты поиска
+volatile Value sink = 0;
+
+//---------- Таблицы -------------------//
+// Обертка над std::unordered_map с интерфейсом таблиц проекта. Память считает
+// CountingAllocator - одновременно должна существовать только одна обертка с данными K и V
+template <typename K, typename V>
+class StdUnorderedMap {
+public:
+	StdUnorderedMap(size_t size, double mlf) {
+		map.max_load_factor(static_cast<float>(mlf));
+		map.rehash(size);
+	}
+
+	bool insert(K key, V value) { return map.emplace(std::move(key), std::move(value)).second; }
+	bool remove(const K& key) { return map.erase(key) != 0; }
+
+	const V* find(const K& key) const {
+		auto it = map.find(key);
+		return it == map.end() ? nullptr : &it->second;
+	}
+
+	size_t size() const noexcept { return map.size(); }
+	size_t max_bucket_count() const noexcept { return map.bucket_count(); }
+	double load_factor() const { return map.load_factor(); }
+
+	size_t memory_usage() const noexcept { return sizeof(*this) + allocation_counter<StdUnorderedMap>().bytes; }
+
+private:
+	std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, CountingAllocator<std::pair<const K, V>, StdUnorderedMap>> map;
+};
+
+// Таблица, к которой операции идут через IHashTable: указатель на интерфейс проходит
+// через volatile, поэтому компилятор не знает конечный тип и не заменяет виртуальный
+// вызов прямым. Сравнение с той же таблицей без обертки показывает цену диспетчеризации
+template <typename Table>
+class VirtualDispatch {
+	using K = typename Table::key_type;
+	using V = typename Table::mapped_type;
+
+public:
+	template <typename... Args>
+	explicit VirtualDispatch(Args&&... args) : table(std::forward<Args>(args)...) {
+		IHashTable<K, V>* volatile escaped = &table;
+		hash_table = escaped;
+	}
+
+	bool insert(K key, V value) { return hash_table->insert(std::move(key), std::move(value)); }
+	bool remove(const K& key) { return hash_table->remove(key); }
+	const V* find(const K& key) const { return std::as_const(*hash_table).find(key); }
+
+	size_t size() const noexcept { return hash_table->size(); }
+	size_t max_bucket_count() const noexcept { return hash_table->max_bucket_count(); }
+	double load_factor() const { return hash_table->load_factor(); }
+
+	size_t memory_usage() const { return sizeof(*this) - sizeof(Table) + table.memory_usage(); }
+
+private:
+	Table table;
+	IHashTable<K, V>* hash_table;
+};
+
+// Описание таблицы для бенчмарка: имя и создание с заданными размером и max load factor
+template <typename K>
+struct StdSpec {
+	using Table = StdUnorderedMap<K, Value>;
+	static constexpr const char* name = "std::unordered_map";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, mlf); }
+};
+
+template <typename K>
+struct ChainSpec {
+	using Table = ChainHashTable<K, Value>;
+	static constexpr const char* name = "ChainHashTable";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, mlf); }
+};
+
+template <typename K>
+struct OpenSpec {
+	using Table = OpenHashTable<K, Value>;
+	static constexpr const char* name = "OpenHashTable";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, 0, 1, mlf); }
+};
+
+template <typename K>
+struct OpenVirtualSpec {
+	using Table = VirtualDispatch<OpenHashTable<K, Value>>;
+	static constexpr const char* name = "OpenHashTable/virtual";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, 0, 1, mlf); }
+};
+
+// Хеш-функции из Hashers.h: таблица та же, что у OpenSpec. Спецификация без Table
+// для какого-то типа ключа - эти ключи хеш-функция не принимает, нагрузки пропускаются
+template <typename K>
+struct OpenMurmurSpec {
+	using Table = OpenHashTable<K, Value, ModuloSizePolicy, MurmurHash<K>>;
+	static constexpr const char* name = "OpenHashTable/MurmurHash";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, 0, 1, mlf); }
+};
+
+template <typename K>
+struct OpenWyHashSpec {
+	static constexpr const char* name = "OpenHashTable/WyHash";
+};
+
+template <typename K> requires std::is_integral_v<K>
+struct OpenWyHashSpec<K> {
+	using Table = OpenHashTable<K, Value, ModuloSizePolicy, WyHash<K>>;
+	static constexpr const char* name = "OpenHashTable/WyHash";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, 0, 1, mlf); }
+};
+
+template <typename K>
+struct OpenStringHashSpec {
+	static constexpr const char* name = "OpenHashTable/StringHash";
+};
+
+template <>
+struct OpenStringHashSpec<std::string> { // прозрачное сравнение: поиск по std::string_view без временной строки
+	using Table = OpenHashTable<std::string, Value, ModuloSizePolicy, StringHash, std::equal_to<>>;
+	static constexpr const char* name = "OpenHashTable/StringHash";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, 0, 1, mlf); }
+};
+
+template <typename K>
+struct OpenIncrementalSpec {
+	using Table = OpenHashTable<K, Value>;
+	static constexpr const char* name = "OpenHashTable/incremental";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, 0, 1, mlf, RehashMode::INCREMENTAL); }
+};
+
+template <typename K>
+struct OpenSplitSpec {
+	using Table = OpenHashTable<K, Value, ModuloSizePolicy, std::hash<K>, std::equal_to<K>, NoStats,
+		std::allocator<std::pair<const K, Value>>, SplitLayout>;
+	static constexpr const char* name = "OpenHashTable/SplitLayout";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, 0, 1, mlf); }
+};
+
+template <typename K>
+struct SwissSpec {
+	using Table = SwissHashTable<K, Value>;
+	static constexpr const char* name = "SwissHashTable";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, mlf); }
+};
+
+template <typename K>
+struct RobinHoodSpec {
+	using Table = RobinHoodHashTable<K, Value>;
+	static constexpr const char* name = "RobinHoodHashTable";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, mlf); }
+};
+
+template <typename K>
+struct CuckooSpec {
+	using Table = CuckooHashTable<K, Value>;
+	static constexpr const char* name = "CuckooHashTable";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, mlf); }
+};
+
+template <typename K>
+struct LockFreeSpec {
+	using Table = LockFreeHashTable<K, Value>;
+	static constexpr const char* name = "LockFreeHashTable";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, 0, 1, mlf); }
+};
+
+template <typename K>
+struct ShardedSpec {
+	using Table = ConcurrentShardedHashTable<OpenHashTable<K, Value>>;
+	static constexpr const char* name = "ConcurrentShardedHashTable/OpenHashTable";
+	static auto make(size_t size, double mlf) {
+		return std::make_unique<Table>(size, Table::default_shard_count(), size_t{ 0 }, size_t{ 1 }, mlf);
+	}
+};
+
+template <typename K>
+struct OrderedSpec {
+	using Table = OrderedHashTable<K, Value>;
+	static constexpr const char* name = "OrderedHashTable";
+	static auto make(size_t size, double mlf) { return std::make_unique<Table>(size, mlf); }
+};
+
+// Имена для ConstexprHashTable и ее соперника, построенного при запуске (Benchmark::run_constexpr)
+struct ConstexprSpec {
+	static constexpr const char* name = "ConstexprHashTable";
+};
+
+struct ConstexprRuntimeSpec {
+	static constexpr const char* name = "ConstexprHashTable/runtime OpenHashTable";
+};
+
+//---------- Измерение -------------------//
+struct Result {
+	std::string table;
+	std::string key;
+	std::string workload;
+	std::string distribution;
+	size_t size = 0;
+	double load_factor = 0;
+	size_t ops = 0;
+	double mean = 0;
+	double p50 = 0;
+	double p99 = 0;
+	double max = 0;
+	double bytes_per_entry = 0; //0 - таблица не сообщает расход памяти или пуста
+	double probe_length = 0;    //средняя длина пробинга; 0 - таблица ее не сообщает
+};
+
+// Выполняет op(0) ... op(ops - 1), время - по пачкам из BATCH операций
+template <typename Op>
+Result measure(size_t ops, Op&& op) {
+	std::vector<double> samples;
+	samples.reserve(ops / BATCH + 1);
+	double total = 0;
+	for (size_t i = 0; i < ops; i += BATCH) {
+		size_t end = std::min(ops, i + BATCH);
+		auto start = Clock::now();
+		for (size_t j = i; j != end; ++j) {
+			op(j);
+		}
+		auto stop = Clock::now();
+		double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+		total += ns;
+		samples.push_back(ns / (end - i));
+	}
+
+	Result result;
+	result.ops = ops;
+	if (samples.empty()) return result;
+	std::sort(samples.begin(), samples.end());
+	result.mean = total / ops;
+	result.p50 = samples[samples.size() / 2];
+	result.p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+	result.max = samples.back();
+	return result;
+}
+
+// Одно измерение на ops операций, начатое в start: время на операцию - общее время / ops
+// (p50, p99 и max совпадают со средним)
+Result single_measurement(size_t ops, Clock::time_point start) {
+	double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+	Result result;
+	result.ops = ops;
+	result.mean = result.p50 = result.p99 = result.max = ops ? ns / ops : 0;
+	return result;
+}
+
+//---------- Ключи -------------------//
+// present - ключи в таблице в порядке вставки, absent - ключи, которых в ней нет
+template <typename K>
+struct KeySet {
+	std::vector<K> present;
+	std::vector<K> absent;
+};
+
+// случайные попарно различные ключи
+template <typename K>
+KeySet<K> random_keys(size_t n, uint64_t seed) {
+	std::mt19937_64 g(seed);
+	std::unordered_set<K> used;
+	std::vector<K> keys;
+	keys.reserve(2 * n);
+	while (keys.size() != 2 * n) {
+		K key;
+		if constexpr (std::is_same_v<K, std::string>) {
+			char buffer[32];
+			std::snprintf(buffer, sizeof(buffer), "user:%016llx", static_cast<unsigned long long>(g()));
+			key = buffer;
+		}
+		else {
+			key = static_cast<K>(g());
+		}
+		if (used.insert(key).second) keys.push_back(std::move(key));
+	}
+	KeySet<K> set;
+	set.present.assign(keys.begin(), keys.begin() + n);
+	set.absent.assign(keys.begin() + n, keys.end());
+	return set;
+}
+
+// ключи 0 .. n - 1 по порядку, промахи - n .. 2n - 1
+KeySet<int> sequential_keys(size_t n) {
+	KeySet<int> set;
+	set.present.resize(n);
+	set.absent.resize(n);
+	std::iota(set.present.begin(), set.present.end(), 0);
+	std::iota(set.absent.begin(), set.absent.end(), static_cast<int>(n));
+	return set;
+}
+
+// Номера ключей для поиска: по порядку, равномерно или по закону Ципфа (s = 0.99)
+std::vector<size_t> access_order(const std::string& distribution, size_t n, size_t ops, uint64_t seed) {
+	std::vector<size_t> order(ops);
+	std::mt19937_64 g(seed);
+	if (distribution == "sequential") {
+		for (size_t i = 0; i != ops; ++i) order[i] = i % n;
+	}
+	else if (distribution == "uniform") {
+		std::uniform_int_distribution<size_t> dist(0, n - 1);
+		for (size_t& index : order) index = dist(g);
+	}
+	else {
+		// частые ключи разбросаны по таблице: ранг -> случайный номер ключа
+		std::vector<double> cdf(n);
+		double sum = 0;
+		for (size_t rank = 0; rank != n; ++rank) {
+			sum += 1.0 / std::pow(static_cast<double>(rank + 1), 0.99);
+			cdf[rank] = sum;
+		}
+		std::vector<size_t> ranked(n);
+		std::iota(ranked.begin(), ranked.end(), 0);
+		std::shuffle(ranked.begin(), ranked.end(), g);
+		std::uniform_real_distribution<double> dist(0, sum);
+		for (size_t& index : order) {
+			size_t rank = std::lower_bound(cdf.begin(), cdf.end(), dist(g)) - cdf.begin();
+			index = ranked[std::min(rank, n - 1)];
+		}
+	}
+	return order;
+}
+
+//---------- Нагрузки -------------------//
+struct Options {
+	size_t size = 1 << 18;
+	std::string format = "csv";
+	std::string out;
+	std::string table;
+};
+
+class Benchmark {
+public:
+	explicit Benchmark(const Options& o) : options(o) {}
+
+	template <template <typename> class Spec>
+	void run() {
+		if (std::string_view(Spec<int>::name).find(options.table) == std::string_view::npos) return;
+		std::cerr << Spec<int>::name << "...\n";
+
+		const size_t n = options.size;
+		if constexpr (requires { typename Spec<int>::Table; }) {
+			KeySet<int> sequential = sequential_keys(n);
+			KeySet<int> uniform = random_keys<int>(n, 1);
+			int_workloads<Spec<int>>("sequential", sequential);
+			int_workloads<Spec<int>>("uniform", uniform);
+			int_workloads<Spec<int>>("zipf", uniform);
+
+			// коэффициент заполнения: таблица без роста заполняется до доли lf своих ячеек
+			for (double lf : { 0.25, 0.5, 0.75, 0.9 }) {
+				load_factor_workload<Spec<int>>(lf, uniform);
+			}
+			table_workloads<Spec<int>>(uniform);
+		}
+
+		if constexpr (requires { typename Spec<std::string>::Table; }) {
+			KeySet<std::string> strings = random_keys<std::string>(n, 2);
+			insert_workload<Spec<std::string>>("string", "uniform", strings);
+			find_workloads<Spec<std::string>>("string", "uniform", strings);
+			if constexpr (requires(const typename Spec<std::string>::Table& t, std::string_view key) { t.find(key); }) {
+				view_workload<Spec<std::string>>(strings);
+			}
+		}
+	}
+
+	// ConstexprHashTable, собранная компилятором, против той же таблицы, построенной
+	// при запуске (OpenHashTable с той же хеш-функцией): поиск по небольшому набору имен
+	void run_constexpr() {
+		if (std::string_view(ConstexprSpec::name).find(options.table) == std::string_view::npos) return;
+		std::cerr << ConstexprSpec::name << "...\n";
+
+		static constexpr std::pair<std::string_view, int> OPCODES[] = {
+			{ "nop", 0 }, { "load", 1 }, { "store", 2 }, { "add", 3 }, { "sub", 4 }, { "mul", 5 }, { "div", 6 },
+			{ "mod", 7 }, { "and", 8 }, { "or", 9 }, { "xor", 10 }, { "not", 11 }, { "shl", 12 }, { "shr", 13 },
+			{ "jmp", 14 }, { "jz", 15 }, { "jnz", 16 }, { "call", 17 }, { "ret", 18 }, { "push", 19 },
+			{ "pop", 20 }, { "cmp", 21 }, { "inc", 22 }, { "dec", 23 }, { "halt", 24 },
+		};
+		static constexpr auto compiled = make_constexpr_table<std::string_view, int>(OPCODES);
+		OpenHashTable<std::string_view, int, ModuloSizePolicy, StringHash> runtime(16);
+		for (const auto& [name, code] : OPCODES) runtime.insert(name, code);
+
+		std::vector<std::string_view> names(options.size);
+		std::mt19937_64 g(9);
+		for (std::string_view& name : names) name = OPCODES[g() % std::size(OPCODES)].first;
+
+		Result constexpr_hit = measure(names.size(), [&](size_t i) {
+			if (const int* value = compiled.find(names[i])) sink = sink + *value;
+		});
+		record<ConstexprSpec>(constexpr_hit, "string_view", "find_hit", "uniform", compiled);
+
+		Result runtime_hit = measure(names.size(), [&](size_t i) {
+			if (const int* value = runtime.find(names[i])) sink = sink + *value;
+		});
+		record<ConstexprRuntimeSpec>(runtime_hit, "string_view", "find_hit", "uniform", runtime);
+	}
+
+	void write(std::ostream& out) const {
+		if (options.format == "json") write_json(out);
+		else write_csv(out);
+	}
+
+private:
+	template <typename Spec>
+	void int_workloads(const std::string& distribution, const KeySet<int>& keys) {
+		if (distribution != "zipf") { // вставка различных ключей не зависит от порядка поиска
+			insert_workload<Spec>("int", distribution, keys);
+			erase_workload<Spec>(distribution, keys);
+		}
+		find_workloads<Spec>("int", distribution, keys);
+		for (int reads : { 50, 90, 99 }) {
+			mixed_workload<Spec>(distribution, reads, keys);
+		}
+	}
+
+	// вставка в пустую таблицу с ростом (в max видны рехэширования)
+	template <typename Spec, typename K>
+	void insert_workload(const std::string& key, const std::string& distribution, const KeySet<K>& keys) {
+		auto table = Spec::make(16, default_mlf);
+		Result result = measure(keys.present.size(), [&](size_t i) {
+			table->insert(keys.present[i], i);
+		});
+		record<Spec>(result, key, "insert", distribution, *table);
+
+		if constexpr (requires(typename Spec::Table& t, std::span<const std::pair<K, Value>> items) { t.insert_bulk(items); }) {
+			bulk_insert_workload<Spec>(key, distribution, keys);
+		}
+	}
+
+	// загрузка тех же ключей одним insert_bulk: время на элемент - общее время / n
+	// (p50, p99 и max совпадают со средним - измерение одно)
+	template <typename Spec, typename K>
+	void bulk_insert_workload(const std::string& key, const std::string& distribution, const KeySet<K>& keys) {
+		std::vector<std::pair<K, Value>> items;
+		items.reserve(keys.present.size());
+		for (size_t i = 0; i != keys.present.size(); ++i) {
+			items.emplace_back(keys.present[i], i);
+		}
+		auto table = Spec::make(16, default_mlf);
+		auto start = Clock::now();
+		table->insert_bulk(items);
+		record<Spec>(single_measurement(items.size(), start), key, "bulk_insert", distribution, *table);
+	}
+
+	// поиск существующих и отсутствующих ключей
+	template <typename Spec, typename K>
+	void find_workloads(const std::string& key, const std::string& distribution, const KeySet<K>& keys) {
+		auto table = filled<Spec>(keys.present, keys.present.size());
+		std::vector<size_t> order = access_order(distribution, keys.present.size(), keys.present.size(), 3);
+
+		Result hit = measure(order.size(), [&](size_t i) {
+			if (const Value* value = table->find(keys.present[order[i]])) sink = sink + *value;
+		});
+		record<Spec>(hit, key, "find_hit", distribution, *table);
+
+		Result miss = measure(order.size(), [&](size_t i) {
+			if (const Value* value = table->find(keys.absent[order[i]])) sink = sink + *value;
+		});
+		record<Spec>(miss, key, "find_miss", distribution, *table);
+
+		if constexpr (requires(const typename Spec::Table& t) { t.freeze(); }) {
+			freeze_workload<Spec>(key, distribution, keys, order, *table);
+		}
+	}
+
+	// freeze() заполненной таблицы: время построения на элемент и байт на элемент
+	// FrozenHashTable (как у bulk_insert, измерение одно), затем поиск в ней
+	template <typename Spec, typename K>
+	void freeze_workload(const std::string& key, const std::string& distribution, const KeySet<K>& keys,
+		const std::vector<size_t>& order, const typename Spec::Table& table) {
+		auto start = Clock::now();
+		auto frozen = table.freeze();
+		record<Spec>(single_measurement(frozen.size(), start), key, "freeze", distribution, frozen);
+
+		Result hit = measure(order.size(), [&](size_t i) {
+			if (const Value* value = frozen.find(keys.present[order[i]])) sink = sink + *value;
+		});
+		record<Spec>(hit, key, "frozen_find_hit", distribution, frozen);
+
+		Result miss = measure(order.size(), [&](size_t i) {
+			if (const Value* value = frozen.find(keys.absent[order[i]])) sink = sink + *value;
+		});
+		record<Spec>(miss, key, "frozen_find_miss", distribution, frozen);
+	}
+
+	template <typename Spec>
+	void erase_workload(const std::string& distribution, const KeySet<int>& keys) {
+		auto table = filled<Spec>(keys.present, keys.present.size());
+		std::vector<int> order = keys.present;
+		std::shuffle(order.begin(), order.end(), std::mt19937_64(4));
+		double lf = table->load_factor();
+		Result result = measure(order.size(), [&](size_t i) {
+			table->remove(order[i]);
+		});
+		record<Spec>(result, "int", "erase", distribution, *table, lf);
+	}
+
+	// reads% поисков, остальное - вставка ключа или его удаление, если он уже есть;
+	// в начале в таблице половина ключей
+	template <typename Spec>
+	void mixed_workload(const std::string& distribution, int reads, const KeySet<int>& keys) {
+		const size_t n = keys.present.size();
+		auto table = filled<Spec>(keys.present, n / 2);
+		std::vector<size_t> order = access_order(distribution, n, n, 5);
+		std::vector<char> is_read(n);
+		std::mt19937_64 g(6);
+		std::uniform_int_distribution<int> percent(0, 99);
+		for (char& read : is_read) read = percent(g) < reads;
+
+		Result result = measure(n, [&](size_t i) {
+			int key = keys.present[order[i]];
+			if (is_read[i]) {
+				if (const Value* value = table->find(key)) sink = sink + *value;
+			}
+			else if (!table->insert(key, i)) {
+				table->remove(key);
+			}
+		});
+		record<Spec>(result, "int", "mixed_" + std::to_string(reads) + "r", distribution, *table);
+	}
+
+	template <typename Spec>
+	void load_factor_workload(double lf, const KeySet<int>& keys) {
+		// емкость - не больше числа ключей, чтобы их хватило до lf = 0.9 при округлении размера вверх
+		auto table = Spec::make(options.size / 2, sweep_mlf);
+		size_t count = std::min(keys.present.size(), static_cast<size_t>(lf * table->max_bucket_count()));
+		for (size_t i = 0; i != count; ++i) {
+			table->insert(keys.present[i], i);
+		}
+		std::vector<size_t> order = access_order("uniform", count, keys.present.size(), 7);
+
+		Result hit = measure(order.size(), [&](size_t i) {
+			if (const Value* value = table->find(keys.present[order[i]])) sink = sink + *value;
+		});
+		record<Spec>(hit, "int", "lf_find_hit", "uniform", *table);
+
+		Result miss = measure(order.size(), [&](size_t i) {
+			if (const Value* value = table->find(keys.absent[order[i]])) sink = sink + *value;
+		});
+		record<Spec>(miss, "int", "lf_find_miss", "uniform", *table);
+	}
+
+	// нагрузки, которые есть не у всех таблиц: пакетный поиск, обход, рехэширование
+	// в несколько потоков, снимки, конкурентная смешанная нагрузка
+	template <typename Spec>
+	void table_workloads(const KeySet<int>& keys) {
+		using Table = typename Spec::Table;
+		if constexpr (requires(const Table& t, std::span<const int> k, std::span<const Value*> r) { t.find_batch(k, r); }) {
+			batch_workload<Spec>(keys);
+		}
+		if constexpr (requires(const Table& t) { t.begin(); t.end(); }) {
+			scan_workload<Spec>(keys);
+		}
+		if constexpr (requires(Table& t) { t.rehash(size_t{}, size_t{}); }) {
+			rehash_workload<Spec>(keys);
+		}
+		if constexpr (requires(const Table& t, const std::string& path) { t.save(path); Table::map(path, false); }) {
+			snapshot_workload<Spec>(keys);
+		}
+		if constexpr (requires(const Table& t) { t.get(0); }) {
+			concurrent_workload<Spec>(keys);
+		}
+	}
+
+	// find_batch по BATCH ключей: время на ключ
+	template <typename Spec>
+	void batch_workload(const KeySet<int>& keys) {
+		auto table = filled<Spec>(keys.present, keys.present.size());
+		std::vector<size_t> order = access_order("uniform", keys.present.size(), keys.present.size(), 3);
+		for (const auto& [workload, source] : { std::pair{ "find_batch_hit", &keys.present }, std::pair{ "find_batch_miss", &keys.absent } }) {
+			std::vector<int> lookups(order.size());
+			for (size_t i = 0; i != order.size(); ++i) lookups[i] = (*source)[order[i]];
+			std::vector<const Value*> found(order.size());
+			Result result = measure(order.size() / BATCH, [&](size_t i) {
+				std::span<const int> batch(lookups.data() + i * BATCH, BATCH);
+				std::as_const(*table).find_batch(batch, std::span<const Value*>(found.data() + i * BATCH, BATCH));
+				if (found[i * BATCH]) sink = sink + *found[i * BATCH];
+			});
+			result.ops *= BATCH;
+			result.mean /= BATCH;
+			result.p50 /= BATCH;
+			result.p99 /= BATCH;
+			result.max /= BATCH;
+			record<Spec>(result, "int", workload, "uniform", *table);
+		}
+	}
+
+	// обход всех элементов: итераторами таблицы и через IHashTable (виртуальные
+	// first_position/next_position, указатель через volatile не дает их убрать)
+	template <typename Spec>
+	void scan_workload(const KeySet<int>& keys) {
+		auto table = filled<Spec>(keys.present, keys.present.size());
+		const auto& direct = *table;
+		auto start = Clock::now();
+		for (const auto& [key, value] : direct) sink = sink + value;
+		record<Spec>(single_measurement(table->size(), start), "int", "scan", "sequential", *table);
+
+		if constexpr (std::derived_from<typename Spec::Table, IHashTable<int, Value>>) {
+			const IHashTable<int, Value>* volatile opaque = table.get();
+			const IHashTable<int, Value>& base = *opaque;
+			start = Clock::now();
+			for (const auto& [key, value] : base) sink = sink + value;
+			record<Spec>(single_measurement(table->size(), start), "int", "scan_interface", "sequential", *table);
+		}
+	}
+
+	// rehash в удвоенный размер в одном потоке и во всех ядрах: время на элемент
+	template <typename Spec>
+	void rehash_workload(const KeySet<int>& keys) {
+		size_t cores = std::max(2u, std::thread::hardware_concurrency());
+		for (size_t threads : { size_t{ 1 }, cores }) {
+			auto table = filled<Spec>(keys.present, keys.present.size());
+			size_t target = table->max_bucket_count() * 2;
+			auto start = Clock::now();
+			table->rehash(target, threads);
+			record<Spec>(single_measurement(table->size(), start), "int", "rehash_" + std::to_string(threads) + "t", "uniform", *table);
+		}
+	}
+
+	// снимок во временный файл: запись, чтение в новую таблицу и отображение в память
+	template <typename Spec>
+	void snapshot_workload(const KeySet<int>& keys) {
+		using Table = typename Spec::Table;
+		auto table = filled<Spec>(keys.present, keys.present.size());
+		const std::string path = (std::filesystem::temp_directory_path() / "HashTablesBench.snapshot").string();
+		auto start = Clock::now();
+		table->save(path);
+		record<Spec>(single_measurement(table->size(), start), "int", "snapshot_save", "uniform", *table);
+
+		start = Clock::now();
+		Table loaded = Table::load(path);
+		sink = sink + *loaded.find(keys.present.front());
+		record<Spec>(single_measurement(table->size(), start), "int", "snapshot_load", "uniform", loaded);
+
+		start = Clock::now();
+		{
+			auto mapped = Table::map(path, false);
+			sink = sink + *mapped.find(keys.present.front());
+		}
+		record<Spec>(single_measurement(table->size(), start), "int", "snapshot_map", "uniform", *table);
+		std::filesystem::remove(path);
+	}
+
+	// 90% поисков, 10% вставок или удалений из 1, 2, 4 и 8 потоков; время на операцию -
+	// общее время / число операций всех потоков (пропускная способность)
+	template <typename Spec>
+	void concurrent_workload(const KeySet<int>& keys) {
+		const size_t n = keys.present.size();
+		for (size_t thread_count : { 1, 2, 4, 8 }) {
+			auto table = filled<Spec>(keys.present, n / 2);
+			std::vector<std::thread> threads;
+			std::vector<size_t> hits(thread_count); // sink не трогаем из потоков
+			auto start = Clock::now();
+			for (size_t t = 0; t != thread_count; ++t) {
+				threads.emplace_back([&, t]() {
+					std::mt19937_64 g(t);
+					std::uniform_int_distribution<size_t> index(0, n - 1);
+					size_t local = 0; // не hits[t]: соседние счетчики делят кеш-линию
+					for (size_t i = 0; i != n / thread_count; ++i) {
+						int key = keys.present[index(g)];
+						if (i % 10 != 0) local += table->contains(key);
+						else if (!table->insert(key, i)) table->remove(key);
+					}
+					hits[t] = local;
+				});
+			}
+			for (auto& thread : threads) thread.join();
+			for (size_t h : hits) sink = sink + h;
+			record<Spec>(single_measurement(n / thread_count * thread_count, start), "int",
+				"mixed_90r_" + std::to_string(thread_count) + "t", "uniform", *table);
+		}
+	}
+
+	// поиск строк по std::string_view (прозрачные Hash и KeyEqual): без временной std::string
+	template <typename Spec>
+	void view_workload(const KeySet<std::string>& keys) {
+		auto table = filled<Spec>(keys.present, keys.present.size());
+		std::vector<std::string_view> views(keys.present.begin(), keys.present.end());
+		std::vector<size_t> order = access_order("uniform", views.size(), views.size(), 3);
+		Result hit = measure(order.size(), [&](size_t i) {
+			if (const Value* value = table->find(views[order[i]])) sink = sink + *value;
+		});
+		record<Spec>(hit, "string", "find_hit_view", "uniform", *table);
+	}
+
+	template <typename Spec, typename K>
+	auto filled(const std::vector<K>& keys, size_t count) {
+		auto table = Spec::make(16, default_mlf);
+		for (size_t i = 0; i != count; ++i) {
+			table->insert(keys[i], i);
+		}
+		return table;
+	}
+
+	// lf < 0 - взять коэффициент заполнения таблицы после нагрузки
+	template <typename Spec, typename Table>
+	void record(Result result, const std::string& key, const std::string& workload,
+		const std::string& distribution, const Table& table, double lf = -1) {
+		result.table = Spec::name;
+		result.key = key;
+		result.workload = workload;
+		result.distribution = distribution;
+		result.size = options.size;
+		result.load_factor = lf < 0 ? table.load_factor() : lf;
+		if constexpr (requires { table.memory_usage(); }) {
+			if (table.size() != 0) result.bytes_per_entry = static_cast<double>(table.memory_usage()) / table.size();
+		}
+		if constexpr (requires { table.average_probe_length(); }) {
+			result.probe_length = table.average_probe_length();
+		}
+		results.push_back(std::move(result));
+	}
+
+	void write_csv(std::ostream& out) const {
+		out << "table,key,workload,distribution,size,load_factor,ops,ns_per_op,p50_ns,p99_ns,max_ns,bytes_per_entry,probe_length\n";
+		for (const Result& r : results) {
+			out << r.table << ',' << r.key << ',' << r.workload << ',' << r.distribution << ','
+				<< r.size << ',' << r.load_factor << ',' << r.ops << ',' << r.mean << ','
+				<< r.p50 << ',' << r.p99 << ',' << r.max << ',';
+			if (r.bytes_per_entry > 0) out << r.bytes_per_entry;
+			out << ',';
+			if (r.probe_length > 0) out << r.probe_length;
+			out << '\n';
+		}
+	}
+
+	void write_json(std::ostream& out) const {
+		out << "{\n  \"batch\": " << BATCH << ",\n  \"results\": [\n";
+		for (size_t i = 0; i != results.size(); ++i) {
+			const Result& r = results[i];
+			out << "    {\"table\": \"" << r.table << "\", \"key\": \"" << r.key
+				<< "\", \"workload\": \"" << r.workload << "\", \"distribution\": \"" << r.distribution
+				<< "\", \"size\": " << r.size << ", \"load_factor\": " << r.load_factor
+				<< ", \"ops\": " << r.ops << ", \"ns_per_op\": " << r.mean << ", \"p50_ns\": " << r.p50
+				<< ", \"p99_ns\": " << r.p99 << ", \"max_ns\": " << r.max << ", \"bytes_per_entry\": ";
+			if (r.bytes_per_entry > 0) out << r.bytes_per_entry;
+			else out << "null";
+			out << ", \"probe_length\": ";
+			if (r.probe_length > 0) out << r.probe_length;
+			else out << "null";
+			out << '}' << (i + 1 != results.size() ? ",\n" : "\n");
+		}
+		out << "  ]\n}\n";
+	}
+
+	// ниже порога роста всех таблиц (у OrderedHashTable он меньше 1)
+	static constexpr double default_mlf = 0.75;
+	static constexpr double sweep_mlf = 0.95;
+
+	Options options;
+	std::vector<Result> results;
+};
+
+int main(int argc, char* argv[]) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (i + 1 == argc) {
+			std::cerr << "Missing value for " << arg << "\n";
+			return 1;
+		}
+		std::string value = argv[++i];
+		if (arg == "--size") options.size = std::stoul(value);
+		else if (arg == "--format") options.format = value;
+		else if (arg == "--out") options.out = value;
+		else if (arg == "--table") options.table = value;
+		else {
+			std::cerr << "Usage: HashTablesBench [--size N] [--format csv|json] [--out file] [--table name]\n";
+			return 1;
+		}
+	}
+	if (options.size < 2 || (options.format != "csv" && options.format != "json")) {
+		std::cerr << "Size must be at least 2, format - csv or json\n";
+		return 1;
+	}
+
+	Benchmark benchmark(options);
+	benchmark.run<StdSpec>();
+	benchmark.run<ChainSpec>();
+	benchmark.run<OpenSpec>();
+	benchmark.run<OpenVirtualSpec>();
+	benchmark.run<OpenIncrementalSpec>();
+	benchmark.run<OpenMurmurSpec>();
+	benchmark.run<OpenWyHashSpec>();
+	benchmark.run<OpenStringHashSpec>();
+	benchmark.run<OpenSplitSpec>();
+	benchmark.run<SwissSpec>();
+	benchmark.run<RobinHoodSpec>();
+	benchmark.run<CuckooSpec>();
+	benchmark.run<LockFreeSpec>();
+	benchmark.run<ShardedSpec>();
+	benchmark.run<OrderedSpec>();
+	benchmark.run_constexpr();
+
+	if (options.out.empty()) {
+		benchmark.write(std::cout);
+	}
+	else {
+		std::ofstream file(options.out);
+		benchmark.write(file);
+	}
+	return 0;
+}
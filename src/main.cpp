@@ -2,6 +2,13 @@
 #include <string>
 #include "ChainHashTable.h"
 #include "OpenHashTable.h"
+#include "SwissHashTable.h"
+#include "RobinHoodHashTable.h"
+#include "CuckooHashTable.h"
+#include "ConcurrentShardedHashTable.h"
+#include "LockFreeHashTable.h"
+#include "OrderedHashTable.h"
+#include "HashTableLike.h"
 #include "HashTableTest.h"
 
 int main() {
@@ -12,6 +19,29 @@ int main() {
 	HashTableTest<ChainHashTable<int, std::string>>::comprehensive_test("Chain Hash Table ( )");
 	std::cout << "-------------------------------------------------\n\n";
 	HashTableTest<OpenHashTable<int, std::string>>::comprehensive_test("Open Hash Table ( )");
+	std::cout << "-------------------------------------------------\n\n";
+	HashTableTest<OpenHashTable<int, std::string, PrimeSizePolicy>>::comprehensive_test("Open Hash Table, PrimeSizePolicy ( , fastmod)");
+	std::cout << "-------------------------------------------------\n\n";
+	HashTableTest<OpenHashTable<int, std::string, PowerOfTwoSizePolicy>>::comprehensive_test("Open Hash Table, PowerOfTwoSizePolicy ( )");
+	std::cout << "-------------------------------------------------\n\n";
+	HashTableTest<OpenHashTable<int, std::string, ModuloSizePolicy, std::hash<int>, std::equal_to<int>, NoStats,
+		std::allocator<std::pair<const int, std::string>>, SplitLayout>>::comprehensive_test("Open Hash Table, SplitLayout ( )");
+	std::cout << "-------------------------------------------------\n\n";
+	HashTableTest<SwissHashTable<int, std::string>>::comprehensive_test("Swiss Hash Table ( , SIMD)");
+	std::cout << "-------------------------------------------------\n\n";
+	HashTableTest<RobinHoodHashTable<int, std::string>>::comprehensive_test("Robin Hood Hash Table ( ,  )");
+	std::cout << "-------------------------------------------------\n\n";
+	HashTableTest<CuckooHashTable<int, std::string>>::comprehensive_test("Cuckoo Hash Table (   4 )");
+	std::cout << "-------------------------------------------------\n\n";
+	HashTableTest<ConcurrentShardedHashTable<ChainHashTable<int, std::string>>>::comprehensive_test("Concurrent Sharded Hash Table ( ChainHashTable)");
+	std::cout << "-------------------------------------------------\n\n";
+	HashTableTest<ConcurrentShardedHashTable<OpenHashTable<int, std::string>>>::comprehensive_test("Concurrent Sharded Hash Table ( OpenHashTable)");
+	std::cout << "-------------------------------------------------\n\n";
+	HashTableTest<LockFreeHashTable<int, std::string>>::comprehensive_test("Lock-Free Hash Table ( ,  )");
+	std::cout << "-------------------------------------------------\n\n";
+	HashTableTest<OrderedHashTable<int, std::string>>::comprehensive_test("Ordered Hash Table (    ,  )");
+	std::cout << "-------------------------------------------------\n\n";
+	HashTableTest<HashTableAdapter<ChainHashTable<int, std::string>>>::comprehensive_test("HashTableAdapter (ChainHashTable   )");
 	
 	return 0;
 }